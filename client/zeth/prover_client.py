@@ -5,9 +5,12 @@
 # SPDX-License-Identifier: LGPL-3.0+
 
 import grpc  # type: ignore
+from typing import List
 from google.protobuf import empty_pb2
 from api.zeth_messages_pb2 import ProofInputs
 from api.snark_messages_pb2 import VerificationKey, ExtendedProof
+from api.prover_pb2 import CommitmentBatch, CommitmentTreeState, \
+    ExtendedProofs
 from api import prover_pb2_grpc  # type: ignore
 
 
@@ -37,6 +40,71 @@ class ProverClient:
             proof = stub.Prove(proof_inputs)
             return proof
 
+    def get_proofs(
+            self,
+            proof_inputs: List[ProofInputs]) -> List[ExtendedProof]:
+        """
+        Request the generation of several proofs in a single call to the
+        proving service. Proofs are returned in the order of the inputs.
+        """
+        with grpc.insecure_channel(self.endpoint) as channel:
+            stub = prover_pb2_grpc.ProverStub(channel)  # type: ignore
+            print("-------------- Get a batch of proofs --------------")
+            return list(stub.ProveBatch(iter(proof_inputs)))
+
+    def get_metrics(self) -> str:
+        """
+        Fetch the metrics of the proving service, in the Prometheus text
+        format
+        """
+        with grpc.insecure_channel(self.endpoint) as channel:
+            stub = prover_pb2_grpc.ProverStub(channel)  # type: ignore
+            metrics = stub.GetMetrics(_make_empty_message())
+            return metrics.prometheus_text
+
+    def append_commitments(
+            self,
+            first_address: int,
+            commitments: List[str]) -> CommitmentTreeState:
+        """
+        Append commitments (hex-encoded) to the commitment tree of the proving
+        service. `first_address` must be the number of commitments already in
+        the tree.
+        """
+        with grpc.insecure_channel(self.endpoint) as channel:
+            stub = prover_pb2_grpc.ProverStub(channel)  # type: ignore
+            batch = CommitmentBatch(
+                first_address=first_address, commitments=commitments)
+            return stub.AppendCommitments(batch)
+
+    def get_commitment_tree_state(self) -> CommitmentTreeState:
+        """
+        Fetch the number of commitments and the root of the commitment tree of
+        the proving service
+        """
+        with grpc.insecure_channel(self.endpoint) as channel:
+            stub = prover_pb2_grpc.ProverStub(channel)  # type: ignore
+            return stub.GetCommitmentTreeState(_make_empty_message())
+
+    def verify(self, extended_proof: ExtendedProof) -> bool:
+        """
+        Verify a proof against the verification key of the proving service
+        """
+        with grpc.insecure_channel(self.endpoint) as channel:
+            stub = prover_pb2_grpc.ProverStub(channel)  # type: ignore
+            return stub.Verify(extended_proof).valid
+
+    def verify_batch(
+            self, extended_proofs: List[ExtendedProof]) -> List[bool]:
+        """
+        Verify several proofs against the verification key of the proving
+        service. Returns the validity of each proof.
+        """
+        with grpc.insecure_channel(self.endpoint) as channel:
+            stub = prover_pb2_grpc.ProverStub(channel)  # type: ignore
+            results = stub.VerifyBatch(ExtendedProofs(proofs=extended_proofs))
+            return list(results.valid)
+
 
 def _make_empty_message() -> empty_pb2.Empty:
     return empty_pb2.Empty()
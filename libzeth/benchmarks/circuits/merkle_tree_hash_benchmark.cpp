@@ -0,0 +1,172 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+// Compare the candidate Merkle tree hashes (the TREE_HASH build option, see
+// circuit_types.hpp), independently of the configured choice:
+//
+//   - the number of constraints and variables of a single hash gadget,
+//   - the size of a Merkle path authenticator of depth <depth>, and the time
+//     to generate its constraints and witness (averaged over <iterations>),
+//   - the size of the full 2-2 joinsplit circuit (ZETH_MERKLE_TREE_DEPTH),
+//   - the time to compute a hash natively.
+//
+// Usage: merkle_tree_hash_benchmark [<depth> [<iterations>]]
+
+#include "libzeth/circuits/circuit_types.hpp"
+#include "libzeth/circuits/joinsplit.tcc"
+#include "libzeth/circuits/merkle_tree/merkle_path_authenticator.hpp"
+#include "libzeth/circuits/mimc/mimc_mp.hpp"
+#include "libzeth/circuits/poseidon/poseidon_tree_hash.hpp"
+#include "libzeth/zeth_constants.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace libzeth;
+
+namespace
+{
+
+const size_t default_depth = 32;
+const size_t default_iterations = 16;
+const size_t native_iterations = 1024;
+
+// Run `f` and return the elapsed time in milliseconds.
+template<typename FnT> double time_ms(FnT f)
+{
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+template<typename HashTreeT>
+void benchmark(const std::string &name, size_t depth, size_t iterations)
+{
+    // Single hash gadget
+    size_t hash_constraints;
+    size_t hash_variables;
+    {
+        libsnark::protoboard<FieldT> pb;
+        libsnark::pb_variable<FieldT> x;
+        libsnark::pb_variable<FieldT> y;
+        x.allocate(pb, "x");
+        y.allocate(pb, "y");
+        HashTreeT hash_gadget(pb, x, y, "hash_gadget");
+        hash_gadget.generate_r1cs_constraints();
+        hash_constraints = pb.num_constraints();
+        hash_variables = pb.num_variables() - 2;
+    }
+
+    // Merkle path authenticator, on random values
+    size_t path_constraints = 0;
+    size_t path_variables = 0;
+    double constraints_ms = 0;
+    double witness_ms = 0;
+    for (size_t i = 0; i < iterations; ++i) {
+        libsnark::protoboard<FieldT> pb;
+        libsnark::pb_variable_array<FieldT> address_bits;
+        address_bits.allocate(pb, depth, "address_bits");
+        libsnark::pb_variable_array<FieldT> path;
+        path.allocate(pb, depth, "path");
+        libsnark::pb_variable<FieldT> leaf;
+        leaf.allocate(pb, "leaf");
+        libsnark::pb_variable<FieldT> expected_root;
+        expected_root.allocate(pb, "expected_root");
+        libsnark::pb_variable<FieldT> enforce_bit;
+        enforce_bit.allocate(pb, "enforce_bit");
+
+        for (size_t j = 0; j < depth; ++j) {
+            pb.val(address_bits[j]) = FieldT(std::rand() & 1);
+            pb.val(path[j]) = FieldT::random_element();
+        }
+        pb.val(leaf) = FieldT::random_element();
+        pb.val(enforce_bit) = FieldT::zero();
+
+        merkle_path_authenticator<FieldT, HashTreeT> auth(
+            pb,
+            depth,
+            address_bits,
+            leaf,
+            expected_root,
+            path,
+            enforce_bit,
+            "authenticator");
+        constraints_ms += time_ms([&]() { auth.generate_r1cs_constraints(); });
+        witness_ms += time_ms([&]() { auth.generate_r1cs_witness(); });
+
+        path_constraints = pb.num_constraints();
+        path_variables = pb.num_variables();
+    }
+
+    // Full joinsplit circuit
+    size_t joinsplit_constraints;
+    {
+        libsnark::protoboard<FieldT> pb;
+        joinsplit_gadget<
+            FieldT,
+            HashT,
+            HashTreeT,
+            2,
+            2,
+            ZETH_MERKLE_TREE_DEPTH>
+            joinsplit_g(pb);
+        joinsplit_g.generate_r1cs_constraints();
+        joinsplit_constraints = pb.num_constraints();
+    }
+
+    // Native hash
+    FieldT h = FieldT::random_element();
+    const FieldT sibling = FieldT::random_element();
+    const double native_ms = time_ms([&]() {
+        for (size_t i = 0; i < native_iterations; ++i) {
+            h = HashTreeT::get_hash(h, sibling);
+        }
+    });
+
+    std::cout << std::setw(10) << name << std::setw(12) << hash_constraints
+              << std::setw(12) << hash_variables << std::setw(12)
+              << path_constraints << std::setw(12) << path_variables
+              << std::fixed << std::setprecision(2) << std::setw(16)
+              << constraints_ms / iterations << std::setw(16)
+              << witness_ms / iterations << std::setw(14)
+              << joinsplit_constraints << std::setprecision(3)
+              << std::setw(14) << 1000.0 * native_ms / native_iterations
+              << "\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    ppT::init_public_params();
+    libff::inhibit_profiling_counters = true;
+    libff::inhibit_profiling_info = true;
+
+    const size_t depth = (argc > 1) ? std::stoul(argv[1]) : default_depth;
+    const size_t iterations =
+        (argc > 2) ? std::stoul(argv[2]) : default_iterations;
+    if (depth == 0 || iterations == 0) {
+        std::cerr << "usage: " << argv[0] << " [<depth> [<iterations>]]\n";
+        return 1;
+    }
+
+    std::cout << "path depth: " << depth << ", joinsplit depth: "
+              << ZETH_MERKLE_TREE_DEPTH << " (times in ms, native in us)\n"
+              << std::setw(10) << "hash" << std::setw(12) << "hash(c)"
+              << std::setw(12) << "hash(v)" << std::setw(12) << "path(c)"
+              << std::setw(12) << "path(v)" << std::setw(16)
+              << "path_constr" << std::setw(16) << "path_witness"
+              << std::setw(14) << "joinsplit(c)" << std::setw(14) << "native"
+              << "\n";
+
+    benchmark<MiMC_mp_gadget<FieldT>>("mimc", depth, iterations);
+    benchmark<Poseidon_tree_hash_gadget<FieldT>>("poseidon", depth, iterations);
+    return 0;
+}
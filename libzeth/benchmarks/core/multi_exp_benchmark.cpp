@@ -0,0 +1,172 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+// Compare `libzeth::multi_exp` with the multi-exponentiation methods of
+// libff, for sizes 2^min_log_size ... 2^max_log_size (by default 2^10 to
+// 2^22, the range of the MPC for Zeth circuits), in G1 or G2.
+//
+// Usage: multi_exp_benchmark [g1|g2 [<min_log_size> [<max_log_size>]]]
+
+#include "libzeth/circuits/circuit_types.hpp"
+#include "libzeth/core/multi_exp.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <libff/algebra/scalar_multiplication/multiexp.hpp>
+#include <string>
+#include <vector>
+
+using namespace libzeth;
+
+using Fr = libff::Fr<ppT>;
+using G1 = libff::G1<ppT>;
+using G2 = libff::G2<ppT>;
+
+namespace
+{
+
+const size_t default_min_log_size = 10;
+const size_t default_max_log_size = 22;
+
+// Run `f` and return the elapsed time in milliseconds.
+template<typename FnT> double time_ms(FnT f)
+{
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+// Generate normalized points cheaply (one addition each), as found in keys.
+template<typename GroupT> std::vector<GroupT> generate_points(size_t n)
+{
+    std::vector<GroupT> points;
+    points.reserve(n);
+    GroupT p = GroupT::random_element();
+    const GroupT step = GroupT::random_element();
+    for (size_t i = 0; i < n; ++i) {
+        p = p + step;
+        points.push_back(p);
+    }
+    GroupT::batch_to_special_all_non_zeros(points);
+    return points;
+}
+
+template<typename GroupT>
+bool benchmark_size(size_t n, size_t num_threads)
+{
+    const std::vector<GroupT> points = generate_points<GroupT>(n);
+    std::vector<Fr> scalars;
+    scalars.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        scalars.push_back(Fr::random_element());
+    }
+
+    GroupT bdlo12;
+    const double bdlo12_ms = time_ms([&]() {
+        bdlo12 = libff::multi_exp_with_mixed_addition<
+            GroupT,
+            Fr,
+            libff::multi_exp_method_BDLO12>(
+            points.begin(), points.end(), scalars.begin(), scalars.end(), 1);
+    });
+
+    GroupT bdlo12_chunks;
+    const double bdlo12_chunks_ms = time_ms([&]() {
+        bdlo12_chunks = libff::multi_exp_with_mixed_addition<
+            GroupT,
+            Fr,
+            libff::multi_exp_method_BDLO12>(
+            points.begin(),
+            points.end(),
+            scalars.begin(),
+            scalars.end(),
+            num_threads);
+    });
+
+    GroupT bos_coster;
+    const double bos_coster_ms = time_ms([&]() {
+        bos_coster = libff::multi_exp_with_mixed_addition<
+            GroupT,
+            Fr,
+            libff::multi_exp_method_bos_coster>(
+            points.begin(),
+            points.end(),
+            scalars.begin(),
+            scalars.end(),
+            num_threads);
+    });
+
+    GroupT pippenger_1;
+    const double pippenger_1_ms = time_ms([&]() {
+        pippenger_1 = multi_exp_pippenger<Fr, GroupT>(
+            points.begin(), points.end(), scalars.begin(), scalars.end(), 1, 0);
+    });
+
+    GroupT pippenger;
+    const double pippenger_ms = time_ms([&]() {
+        pippenger = multi_exp_pippenger<Fr, GroupT>(
+            points.begin(), points.end(), scalars.begin(), scalars.end(), 0, 0);
+    });
+
+    std::cout << std::setw(8) << libff::log2(n) << std::fixed
+              << std::setprecision(1) << std::setw(14) << bdlo12_ms
+              << std::setw(14) << bdlo12_chunks_ms << std::setw(14)
+              << bos_coster_ms << std::setw(14) << pippenger_1_ms
+              << std::setw(14) << pippenger_ms << std::setw(8)
+              << multi_exp_window_bits(n) << "\n";
+
+    return bdlo12_chunks == bdlo12 && bos_coster == bdlo12 &&
+           pippenger_1 == bdlo12 && pippenger == bdlo12;
+}
+
+template<typename GroupT>
+bool benchmark(size_t min_log_size, size_t max_log_size)
+{
+    const size_t num_threads = multi_exp_num_threads(~(size_t)0, 0);
+    std::cout << "threads: " << num_threads << " (times in ms)\n"
+              << std::setw(8) << "log(n)" << std::setw(14) << "BDLO12"
+              << std::setw(14) << "BDLO12(mt)" << std::setw(14)
+              << "bos_coster(mt)" << std::setw(14) << "pippenger"
+              << std::setw(14) << "pippenger(mt)" << std::setw(8) << "window"
+              << "\n";
+
+    bool all_match = true;
+    for (size_t log_size = min_log_size; log_size <= max_log_size; ++log_size) {
+        all_match &= benchmark_size<GroupT>((size_t)1 << log_size, num_threads);
+    }
+    return all_match;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    ppT::init_public_params();
+    libff::inhibit_profiling_counters = true;
+    libff::inhibit_profiling_info = true;
+
+    const std::string group = (argc > 1) ? argv[1] : "g1";
+    const size_t min_log_size =
+        (argc > 2) ? std::stoul(argv[2]) : default_min_log_size;
+    const size_t max_log_size =
+        (argc > 3) ? std::stoul(argv[3]) : default_max_log_size;
+    if ((group != "g1" && group != "g2") || min_log_size > max_log_size) {
+        std::cerr << "usage: " << argv[0]
+                  << " [g1|g2 [<min_log_size> [<max_log_size>]]]\n";
+        return 1;
+    }
+
+    const bool all_match =
+        (group == "g1") ? benchmark<G1>(min_log_size, max_log_size)
+                        : benchmark<G2>(min_log_size, max_log_size);
+    if (!all_match) {
+        std::cerr << "error: results differ between methods\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,121 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+// Compare the costs of the Groth16 verification paths:
+//
+//   - the libsnark verifier, which processes the verification key (computing
+//     e(alpha, beta) and the G2 precomputations) on every call,
+//   - `verify` with a verification key prepared once,
+//   - `verify_batch` with a prepared verification key.
+//
+// Usage: groth16_verify_benchmark [<num_proofs>]
+
+#include "libzeth/circuits/circuit_types.hpp"
+#include "libzeth/snarks/groth16/groth16_snark.hpp"
+#include "libzeth/tests/circuits/simple_test.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace libzeth;
+
+using Fr = libff::Fr<ppT>;
+using snark = groth16_snark<ppT>;
+
+namespace
+{
+
+const size_t default_num_proofs = 64;
+
+// Run `f` and return the elapsed time in microseconds.
+template<typename FnT> double time_us(FnT f)
+{
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::micro>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+void report(const char *name, double total_us, size_t num_proofs)
+{
+    std::cout << std::left << std::setw(28) << name << std::right
+              << std::setw(12) << std::fixed << std::setprecision(1)
+              << total_us / (double)num_proofs << " us/proof\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    ppT::init_public_params();
+    libff::inhibit_profiling_counters = true;
+    libff::inhibit_profiling_info = true;
+
+    const size_t num_proofs =
+        (argc > 1) ? std::stoul(argv[1]) : default_num_proofs;
+    if (num_proofs == 0) {
+        std::cerr << "usage: " << argv[0] << " [<num_proofs>]\n";
+        return 1;
+    }
+
+    // Satisfying assignment for the simple circuit (x = 3).
+    const libsnark::r1cs_primary_input<Fr> primary{Fr(74)};
+    const libsnark::r1cs_auxiliary_input<Fr> auxiliary{Fr(3), Fr(9), Fr(27)};
+
+    libsnark::protoboard<Fr> pb;
+    libzeth::test::simple_circuit<Fr>(pb);
+    const snark::KeypairT keypair = snark::generate_setup(pb);
+
+    const std::vector<libsnark::r1cs_primary_input<Fr>> primary_inputs(
+        num_proofs, primary);
+    std::vector<snark::ProofT> proofs;
+    proofs.reserve(num_proofs);
+    for (size_t i = 0; i < num_proofs; ++i) {
+        proofs.push_back(snark::generate_proof(keypair.pk, primary, auxiliary));
+    }
+
+    bool all_valid = true;
+
+    const double libsnark_us = time_us([&]() {
+        for (const snark::ProofT &proof : proofs) {
+            all_valid &= snark::verify(primary, proof, keypair.vk);
+        }
+    });
+
+    std::unique_ptr<snark::PreparedVerificationKeyT> pvk;
+    const double prepare_us = time_us([&]() {
+        pvk.reset(new snark::PreparedVerificationKeyT(
+            snark::prepare_verification_key(keypair.vk)));
+    });
+
+    const double prepared_us = time_us([&]() {
+        for (const snark::ProofT &proof : proofs) {
+            all_valid &= snark::verify(primary, proof, *pvk);
+        }
+    });
+
+    const double batch_us = time_us([&]() {
+        all_valid &= snark::verify_batch(primary_inputs, proofs, *pvk);
+    });
+
+    std::cout << "proofs: " << num_proofs << "\n";
+    std::cout << std::left << std::setw(28) << "prepare_verification_key"
+              << std::right << std::setw(12) << std::fixed
+              << std::setprecision(1) << prepare_us << " us\n";
+    report("verify (libsnark vk)", libsnark_us, num_proofs);
+    report("verify (prepared vk)", prepared_us, num_proofs);
+    report("verify_batch (prepared vk)", batch_us, num_proofs);
+
+    if (!all_valid) {
+        std::cerr << "error: a valid proof was rejected\n";
+        return 1;
+    }
+    return 0;
+}
@@ -77,17 +77,13 @@ template<typename FieldT> void BLAKE2s_256<FieldT>::generate_r1cs_witness()
 
     // Push the block variable in local variable to be padded
     std::vector<FieldT> padded_input;
+    padded_input.reserve(nb_blocks * BLAKE2s_block_size);
     for (size_t i = 0; i < input_size; i++) {
         padded_input.push_back(this->pb.val(input.bits[i]));
     }
 
     // [SANITY CHECK] Pad if necessary (if input_size % BLAKE2s_block_size != 0)
-    size_t to_pad = input_size % BLAKE2s_block_size;
-    if (to_pad != 0) {
-        for (size_t i = 0; i < BLAKE2s_block_size - to_pad; i++) {
-            padded_input.push_back(FieldT("0"));
-        }
-    }
+    padded_input.resize(nb_blocks * BLAKE2s_block_size, FieldT::zero());
 
     for (size_t i = 0; i < nb_blocks; i++) {
         std::vector<FieldT> temp_vector(
@@ -96,16 +92,13 @@ template<typename FieldT> void BLAKE2s_256<FieldT>::generate_r1cs_witness()
         block[i].bits.fill_with_field_elements(this->pb, temp_vector);
     }
 
+    // Initial chaining value (IV XOR parameter block).
     // See: Appendix A.1 of https://blake2.net/blake2.pdf
-    std::vector<bool> h_bits;
+    const BLAKE2s_256_native::state_t h_words = BLAKE2s_256_native::initial_h();
     for (size_t i = 0; i < 8; i++) {
-        std::array<bool, BLAKE2s_word_size> pb_swapped =
-            swap_byte_endianness(parameter_block[i]);
-        std::vector<bool> h_part =
-            bits32_to_vector(bits_xor(pb_swapped, BLAKE2s_IV[i]));
-        h_bits.insert(h_bits.end(), h_part.begin(), h_part.end());
+        fill_with_word32(
+            this->pb, h[0].bits.begin() + BLAKE2s_word_size * i, h_words[i]);
     }
-    h[0].bits.fill_with_bits(this->pb, h_bits);
 
     for (size_t i = 0; i < nb_blocks - 1; i++) {
         BLAKE2sC_vector[i].generate_r1cs_witness(
@@ -141,19 +134,7 @@ size_t BLAKE2s_256<FieldT>::expected_constraints(
 template<typename FieldT>
 libff::bit_vector BLAKE2s_256<FieldT>::get_hash(const libff::bit_vector &input)
 {
-    libsnark::protoboard<FieldT> pb;
-
-    libsnark::block_variable<FieldT> input_block(
-        pb, input.size(), "input_block");
-    libsnark::digest_variable<FieldT> output_variable(
-        pb, BLAKE2s_digest_size, "output_variable");
-    BLAKE2s_256<FieldT> blake2s_hasher(
-        pb, input_block, output_variable, "blake2s_hasher_gadget");
-
-    input_block.generate_r1cs_witness(input);
-    blake2s_hasher.generate_r1cs_witness();
-
-    return output_variable.get_digest();
+    return BLAKE2s_256_native::get_hash(input);
 }
 
 } // namespace libzeth
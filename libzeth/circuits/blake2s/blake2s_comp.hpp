@@ -6,6 +6,7 @@
 #define __ZETH_CIRCUITS_BLAKE2S_COMP_HPP__
 
 #include "libzeth/circuits/binary_operation.hpp"
+#include "libzeth/circuits/blake2s/blake2s_native.hpp"
 #include "libzeth/circuits/blake2s/g_primitive.hpp"
 #include "libzeth/circuits/circuit_utils.hpp"
 #include "libzeth/core/bits.hpp"
@@ -33,17 +34,10 @@ template<typename FieldT>
 class BLAKE2s_256_comp : public libsnark::gadget<FieldT>
 {
 private:
-    // See: Appendix A.2 of https://blake2.net/blake2.pdf for the specification
-    // of the IV used in BLAKE2s
-    static const std::array<std::array<bool, BLAKE2s_word_size>, 8> BLAKE2s_IV;
-
     // Section 2.1 of https://blake2.net/blake2.pdf specifies that BLAKE2s has
     // 10 rounds
     static const int rounds = 10;
 
-    // Low and High words of the offset
-    std::array<std::array<bool, BLAKE2s_word_size>, 2> t;
-
     // Chaining values
     libsnark::digest_variable<FieldT> h;
     std::array<libsnark::pb_variable_array<FieldT>, 8> h_array;
@@ -83,7 +77,12 @@ public:
     void generate_r1cs_constraints(const bool ensure_output_bitness = true);
 
     // We set the flags' and counters' default value for one compression
-    // function with full block length input
+    // function with full block length input.
+    //
+    // The compression function is evaluated natively on 32-bit words (see
+    // BLAKE2s_256_native), and the bits of all the variables of the gadget
+    // are assigned from the resulting words, rather than by evaluating the
+    // bit-level sub-gadgets. The circuit is unchanged.
     void generate_r1cs_witness(
         size_t len_byte_total = 32, bool is_last_block = true);
 
@@ -93,10 +92,7 @@ public:
 
     static size_t expected_constraints(const bool ensure_output_bitness);
 
-    // Helper functions to initialize the compression function parameters
-    void setup_h();
-    void setup_counter(size_t len_byte_total);
-    void setup_v(bool is_last_block);
+    // Helper function to initialize the compression function gadgets
     void setup_mixing_gadgets();
 };
 
@@ -93,69 +93,78 @@ template<typename FieldT>
 void BLAKE2s_256_comp<FieldT>::generate_r1cs_witness(
     size_t len_byte_total, bool is_last_block)
 {
-    // Format two 256-bit long big endian inputs into one 512 long little endian
-    // input (with padding if necessary)
-    size_t input_size = input_block.bits.size();
-    // We do not use block_size because the value might not be entered
-    // (c.f. block_variable<FieldT>::block_variable(
-    //     protoboard<FieldT> &pb,
-    //     const std::vector<pb_variable_array<FieldT>> &parts,
-    //     const std::string &annotation_prefix))
-
-    // Push the block variable in local to be swapped
-    std::vector<FieldT> padded_input;
-    for (size_t i = 0; i < input_size; i++) {
-        padded_input.push_back(this->pb.val(input_block.bits[i]));
+    // Format the (big endian) input into 16 little endian words (with padding
+    // if the input is shorter than BLAKE2s_block_size)
+    const libff::bit_vector input_bits = input_block.get_block();
+    BLAKE2s_256_native::block_t m;
+    for (size_t i = 0; i < BLAKE2s_word_number; i++) {
+        m[i] = BLAKE2s_256_native::load_word(input_bits, BLAKE2s_word_size * i);
+        fill_with_word32(this->pb, block[i].begin(), m[i]);
     }
 
-    // [SANITY CHECK] Pad if necessary (if input_size < BLAKE2s_block_size)
-    for (size_t i = 0; i < BLAKE2s_block_size - input_size; i++) {
-        padded_input.push_back(FieldT("0"));
+    // Chaining value
+    BLAKE2s_256_native::state_t h_words;
+    for (size_t i = 0; i < 8; i++) {
+        h_words[i] =
+            get_word32(this->pb, h.bits.begin() + BLAKE2s_word_size * i);
+        fill_with_word32(this->pb, h_array[i].begin(), h_words[i]);
     }
 
-    // Allocate and format the 16 input block variable
-    for (size_t i = 0; i < BLAKE2s_word_number; i++) {
-        std::vector<FieldT> temp_vector(
-            padded_input.begin() + BLAKE2s_word_size * i,
-            padded_input.begin() + BLAKE2s_word_size * (i + 1));
-        temp_vector = swap_byte_endianness(temp_vector);
-        block[i].fill_with_field_elements(this->pb, temp_vector);
+    // Initial state. See: Appendix A.1 of https://blake2.net/blake2.pdf
+    // len_byte_total represents the BYTE length all the input blocks
+    // compressed so far, up to 2^64 - 1 bytes for blake2s
+    std::array<uint32_t, BLAKE2s_word_number> v_words;
+    for (size_t i = 0; i < 8; i++) {
+        v_words[i] = h_words[i];
+        v_words[8 + i] = BLAKE2s_256_native::IV[i];
+    }
+    v_words[12] ^= (uint32_t)len_byte_total;
+    v_words[13] ^= (uint32_t)((uint64_t)len_byte_total >> 32);
+    if (is_last_block) {
+        v_words[14] = ~v_words[14];
+    }
+    for (size_t j = 0; j < BLAKE2s_word_number; j++) {
+        fill_with_word32(this->pb, v[0][j].begin(), v_words[j]);
     }
 
-    BLAKE2s_256_comp<FieldT>::setup_h();
-    BLAKE2s_256_comp<FieldT>::setup_counter(len_byte_total);
-    BLAKE2s_256_comp<FieldT>::setup_v(is_last_block);
-
+    // Each mixing gadget assigns its outputs (in v_temp and v), and updates
+    // the corresponding state words. See setup_mixing_gadgets.
+    static const std::array<std::array<size_t, 4>, 8> g_state_words = {{
+        {{0, 4, 8, 12}},
+        {{1, 5, 9, 13}},
+        {{2, 6, 10, 14}},
+        {{3, 7, 11, 15}},
+        {{0, 5, 10, 15}},
+        {{1, 6, 11, 12}},
+        {{2, 7, 8, 13}},
+        {{3, 4, 9, 14}},
+    }};
     for (size_t i = 0; i < rounds; i++) {
-        for (auto &gadget : g_arrays[i]) {
-            gadget.generate_r1cs_witness();
+        const std::array<uint8_t, 16> &s = BLAKE2s_256_native::sigma[i];
+        for (size_t j = 0; j < g_state_words.size(); j++) {
+            const std::array<size_t, 4> &w = g_state_words[j];
+            g_arrays[i][j].generate_r1cs_witness_from_words(
+                v_words[w[0]],
+                v_words[w[1]],
+                v_words[w[2]],
+                v_words[w[3]],
+                m[s[2 * j]],
+                m[s[2 * j + 1]]);
         }
     }
 
-    // TODO: batch equality constraints (should save ~200 constraints (~1%))
-
-    for (auto &gadget : xor_vector) {
-        gadget.generate_r1cs_witness();
-    }
-
-    // Retrieve values, swap endiannes of each bit32 and append them to get
-    // final output
-    std::vector<FieldT> output_conversion;
+    // Output words, swapped to big endian if it is the last call
     for (size_t i = 0; i < 8; i++) {
-        std::vector<FieldT> output_byte_value =
-            output_bytes[i].get_vals(this->pb);
-
-        // We swap to big endian if it is the last call.
-        if (is_last_block) {
-            output_byte_value = swap_byte_endianness(output_byte_value);
-        }
-        output_conversion.insert(
-            output_conversion.end(),
-            output_byte_value.begin(),
-            output_byte_value.end());
+        const uint32_t out_temp_word = v_words[i] ^ v_words[8 + i];
+        const uint32_t output_word = out_temp_word ^ h_words[i];
+        fill_with_word32(this->pb, out_temp[i].begin(), out_temp_word);
+        fill_with_word32(this->pb, output_bytes[i].begin(), output_word);
+        fill_with_word32(
+            this->pb,
+            output.bits.begin() + BLAKE2s_word_size * i,
+            is_last_block ? BLAKE2s_256_native::byte_swap(output_word)
+                          : output_word);
     }
-
-    output.bits.fill_with_field_elements(this->pb, output_conversion);
 };
 
 template<typename FieldT> size_t BLAKE2s_256_comp<FieldT>::get_digest_len()
@@ -0,0 +1,136 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#include "libzeth/circuits/blake2s/blake2s_native.hpp"
+
+#include <algorithm>
+
+namespace libzeth
+{
+
+const BLAKE2s_256_native::state_t BLAKE2s_256_native::IV = {{
+    0x6A09E667,
+    0xBB67AE85,
+    0x3C6EF372,
+    0xA54FF53A,
+    0x510E527F,
+    0x9B05688C,
+    0x1F83D9AB,
+    0x5BE0CD19,
+}};
+
+const std::array<std::array<uint8_t, 16>, BLAKE2s_256_native::rounds>
+    BLAKE2s_256_native::sigma = {{
+        {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+        {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
+        {11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4},
+        {7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8},
+        {9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13},
+        {2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9},
+        {12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11},
+        {13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10},
+        {6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5},
+        {10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0},
+    }};
+
+void BLAKE2s_256_native::g(
+    uint32_t &a, uint32_t &b, uint32_t &c, uint32_t &d, uint32_t x, uint32_t y)
+{
+    a = a + b + x;
+    d = rotr(d ^ a, 16);
+    c = c + d;
+    b = rotr(b ^ c, 12);
+    a = a + b + y;
+    d = rotr(d ^ a, 8);
+    c = c + d;
+    b = rotr(b ^ c, 7);
+}
+
+BLAKE2s_256_native::state_t BLAKE2s_256_native::initial_h()
+{
+    // Parameter block: digest length 32, key length 0, fanout 1, depth 1.
+    // All other parameters are zero. See: Section 2.8 of
+    // https://blake2.net/blake2.pdf
+    state_t h = IV;
+    h[0] ^= 0x01010020;
+    return h;
+}
+
+void BLAKE2s_256_native::compress(
+    state_t &h, const block_t &m, uint64_t t, bool is_last_block)
+{
+    // See: Section 3.2 of https://tools.ietf.org/html/rfc7693
+    std::array<uint32_t, 16> v;
+    for (size_t i = 0; i < 8; ++i) {
+        v[i] = h[i];
+        v[i + 8] = IV[i];
+    }
+    v[12] ^= (uint32_t)t;
+    v[13] ^= (uint32_t)(t >> 32);
+    if (is_last_block) {
+        v[14] = ~v[14];
+    }
+
+    for (size_t r = 0; r < rounds; ++r) {
+        const std::array<uint8_t, 16> &s = sigma[r];
+        g(v[0], v[4], v[8], v[12], m[s[0]], m[s[1]]);
+        g(v[1], v[5], v[9], v[13], m[s[2]], m[s[3]]);
+        g(v[2], v[6], v[10], v[14], m[s[4]], m[s[5]]);
+        g(v[3], v[7], v[11], v[15], m[s[6]], m[s[7]]);
+        g(v[0], v[5], v[10], v[15], m[s[8]], m[s[9]]);
+        g(v[1], v[6], v[11], v[12], m[s[10]], m[s[11]]);
+        g(v[2], v[7], v[8], v[13], m[s[12]], m[s[13]]);
+        g(v[3], v[4], v[9], v[14], m[s[14]], m[s[15]]);
+    }
+
+    for (size_t i = 0; i < 8; ++i) {
+        h[i] ^= v[i] ^ v[i + 8];
+    }
+}
+
+uint32_t BLAKE2s_256_native::load_word(
+    const std::vector<bool> &bits, size_t offset)
+{
+    uint32_t word = 0;
+    for (size_t byte = 0; byte < 4; ++byte) {
+        for (size_t bit = 0; bit < 8; ++bit) {
+            const size_t index = offset + 8 * byte + bit;
+            if (index < bits.size() && bits[index]) {
+                word |= (uint32_t)1 << (8 * byte + 7 - bit);
+            }
+        }
+    }
+    return word;
+}
+
+std::vector<bool> BLAKE2s_256_native::get_hash(const std::vector<bool> &input)
+{
+    const size_t block_size = 512;
+    const size_t num_bytes = (input.size() + 7) / 8;
+    const size_t num_blocks =
+        std::max<size_t>(1, (input.size() + block_size - 1) / block_size);
+
+    state_t h = initial_h();
+    for (size_t i = 0; i < num_blocks; ++i) {
+        block_t m;
+        for (size_t j = 0; j < m.size(); ++j) {
+            m[j] = load_word(input, i * block_size + 32 * j);
+        }
+        const bool is_last_block = (i == num_blocks - 1);
+        compress(h, m, is_last_block ? num_bytes : 64 * (i + 1), is_last_block);
+    }
+
+    // The digest is the little-endian encoding of the chaining value
+    std::vector<bool> digest;
+    digest.reserve(32 * h.size());
+    for (const uint32_t word : h) {
+        const uint32_t swapped = byte_swap(word);
+        for (size_t bit = 0; bit < 32; ++bit) {
+            digest.push_back((swapped >> (31 - bit)) & 1);
+        }
+    }
+    return digest;
+}
+
+} // namespace libzeth
@@ -0,0 +1,72 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_CIRCUITS_BLAKE2S_NATIVE_HPP__
+#define __ZETH_CIRCUITS_BLAKE2S_NATIVE_HPP__
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Native (out-of-circuit) implementation of BLAKE2s-256, operating on 32-bit
+// words. It uses the parameters of the BLAKE2s_256 gadget (32-byte digest, no
+// key, salt or personalization) and computes the same values as the gadgets,
+// without building a protoboard.
+
+namespace libzeth
+{
+
+class BLAKE2s_256_native
+{
+public:
+    using state_t = std::array<uint32_t, 8>;
+    using block_t = std::array<uint32_t, 16>;
+
+    // Section 2.1 of https://blake2.net/blake2.pdf
+    static const size_t rounds = 10;
+
+    // See: Appendix A.2 of https://blake2.net/blake2.pdf
+    static const state_t IV;
+
+    // See: Appendix A.1 of https://blake2.net/blake2.pdf
+    static const std::array<std::array<uint8_t, 16>, rounds> sigma;
+
+    static uint32_t rotr(uint32_t word, unsigned shift)
+    {
+        return (word >> shift) | (word << (32 - shift));
+    }
+
+    // Mixing function G, applied in place to (a, b, c, d).
+    // See: Section 3.1 of https://tools.ietf.org/html/rfc7693
+    static void g(
+        uint32_t &a, uint32_t &b, uint32_t &c, uint32_t &d, uint32_t x, uint32_t y);
+
+    // Initial chaining value: IV XOR the parameter block.
+    static state_t initial_h();
+
+    // Compression function F, applied in place to the chaining value `h`.
+    // `t` is the number of bytes compressed so far (including this block).
+    static void compress(
+        state_t &h, const block_t &m, uint64_t t, bool is_last_block);
+
+    // Hash a bit string (bytes in order, each byte most significant bit
+    // first, zero-padded to a full block), with the same conventions as
+    // BLAKE2s_256<FieldT>::get_hash.
+    static std::vector<bool> get_hash(const std::vector<bool> &input);
+
+    // Little-endian word formed by the 4 bytes at bit offset `offset` of
+    // `bits`, bits past the end being zero.
+    static uint32_t load_word(const std::vector<bool> &bits, size_t offset);
+
+    static uint32_t byte_swap(uint32_t word)
+    {
+        return (word >> 24) | ((word >> 8) & 0xff00) |
+               ((word << 8) & 0xff0000) | (word << 24);
+    }
+};
+
+} // namespace libzeth
+
+#endif // __ZETH_CIRCUITS_BLAKE2S_NATIVE_HPP__
@@ -6,6 +6,7 @@
 #define __ZETH_CIRCUITS_G_PRIMITIVE_HPP__
 
 #include "libzeth/circuits/binary_operation.hpp"
+#include "libzeth/circuits/blake2s/blake2s_native.hpp"
 #include "libzeth/circuits/circuit_utils.hpp"
 #include "libzeth/core/bits.hpp"
 
@@ -66,6 +67,13 @@ public:
 
     void generate_r1cs_constraints();
     void generate_r1cs_witness();
+
+    // Witness the gadget from the values (a, b, c, d, x, y) of its inputs,
+    // computing G on 32-bit words and assigning the bits of the internal and
+    // output variables directly. The inputs are not assigned. On return,
+    // (a, b, c, d) hold the output values (a2, b2, c2, d2).
+    void generate_r1cs_witness_from_words(
+        uint32_t &a, uint32_t &b, uint32_t &c, uint32_t &d, uint32_t x, uint32_t y);
 };
 
 } // namespace libzeth
@@ -98,6 +98,37 @@ template<typename FieldT> void g_primitive<FieldT>::generate_r1cs_witness()
     b2_xor_gadget->generate_r1cs_witness();
 };
 
+template<typename FieldT>
+void g_primitive<FieldT>::generate_r1cs_witness_from_words(
+    uint32_t &a, uint32_t &b, uint32_t &c, uint32_t &d, uint32_t x, uint32_t y)
+{
+    // Same steps as the sub-gadgets (see the constructor)
+    const uint32_t a1_temp_word = a + b;
+    const uint32_t a1_word = a1_temp_word + x;
+    const uint32_t d1_word =
+        BLAKE2s_256_native::rotr(d ^ a1_word, rotation_constant_r1);
+    const uint32_t c1_word = c + d1_word;
+    const uint32_t b1_word =
+        BLAKE2s_256_native::rotr(b ^ c1_word, rotation_constant_r2);
+
+    const uint32_t a2_temp_word = a1_word + b1_word;
+    a = a2_temp_word + y;
+    d = BLAKE2s_256_native::rotr(d1_word ^ a, rotation_constant_r3);
+    c = c1_word + d;
+    b = BLAKE2s_256_native::rotr(b1_word ^ c, rotation_constant_r4);
+
+    fill_with_word32(this->pb, a1_temp.begin(), a1_temp_word);
+    fill_with_word32(this->pb, a1.begin(), a1_word);
+    fill_with_word32(this->pb, d1.begin(), d1_word);
+    fill_with_word32(this->pb, c1.begin(), c1_word);
+    fill_with_word32(this->pb, b1.begin(), b1_word);
+    fill_with_word32(this->pb, a2_temp.begin(), a2_temp_word);
+    fill_with_word32(this->pb, a2.begin(), a);
+    fill_with_word32(this->pb, d2.begin(), d);
+    fill_with_word32(this->pb, c2.begin(), c);
+    fill_with_word32(this->pb, b2.begin(), b);
+}
+
 } // namespace libzeth
 
 #endif // __ZETH_CIRCUITS_G_PRIMITIVE_TCC__
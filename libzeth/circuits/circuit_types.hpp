@@ -8,6 +8,7 @@
 #include "libzeth/circuits/blake2s/blake2s.hpp"
 #include "libzeth/circuits/circuit_wrapper.hpp"
 #include "libzeth/circuits/mimc/mimc_mp.hpp"
+#include "libzeth/circuits/poseidon/poseidon_tree_hash.hpp"
 #include "libzeth/core/include_libsnark.hpp"
 
 // Types that must be common across all executable, defined once here. Outside
@@ -26,8 +27,14 @@ using FieldT = libff::Fr<ppT>;
 // Hash used for the commitments and PRFs
 using HashT = BLAKE2s_256<FieldT>;
 
-// Hash function to be used in the Merkle Tree
+// Hash function to be used in the Merkle Tree (TREE_HASH build option)
+#if defined(TREE_HASH_MIMC)
 using HashTreeT = MiMC_mp_gadget<FieldT>;
+#elif defined(TREE_HASH_POSEIDON)
+using HashTreeT = Poseidon_tree_hash_gadget<FieldT>;
+#else
+#error "TREE_HASH_MIMC or TREE_HASH_POSEIDON must be defined"
+#endif
 
 } // namespace libzeth
 
@@ -7,6 +7,7 @@
 
 #include "libzeth/core/bits.hpp"
 
+#include <cstdint>
 #include <libsnark/gadgetlib1/pb_variable.hpp>
 
 namespace libzeth
@@ -19,6 +20,18 @@ template<typename FieldT>
 libsnark::pb_variable_array<FieldT> variable_array_from_bit_vector(
     const std::vector<bool> &bits, const libsnark::pb_variable<FieldT> &ZERO);
 
+// Assign `word` to 32 bit variables starting at `begin` (most significant bit
+// first), and read it back.
+template<typename FieldT>
+void fill_with_word32(
+    libsnark::protoboard<FieldT> &pb,
+    typename libsnark::pb_variable_array<FieldT>::const_iterator begin,
+    uint32_t word);
+template<typename FieldT>
+uint32_t get_word32(
+    const libsnark::protoboard<FieldT> &pb,
+    typename libsnark::pb_variable_array<FieldT>::const_iterator begin);
+
 } // namespace libzeth
 
 #include "libzeth/circuits/circuit_utils.tcc"
@@ -63,6 +63,32 @@ libsnark::pb_variable_array<FieldT> variable_array_from_bit_vector(
     return acc;
 };
 
+template<typename FieldT>
+void fill_with_word32(
+    libsnark::protoboard<FieldT> &pb,
+    typename libsnark::pb_variable_array<FieldT>::const_iterator begin,
+    uint32_t word)
+{
+    for (size_t i = 0; i < 32; ++i) {
+        pb.val(*(begin + i)) =
+            ((word >> (31 - i)) & 1) ? FieldT::one() : FieldT::zero();
+    }
+}
+
+template<typename FieldT>
+uint32_t get_word32(
+    const libsnark::protoboard<FieldT> &pb,
+    typename libsnark::pb_variable_array<FieldT>::const_iterator begin)
+{
+    uint32_t word = 0;
+    for (size_t i = 0; i < 32; ++i) {
+        if (pb.val(*(begin + i)) == FieldT::one()) {
+            word |= (uint32_t)1 << (31 - i);
+        }
+    }
+    return word;
+}
+
 } // namespace libzeth
 
 #endif // __ZETH_CIRCUITS_CIRCUITS_UTILS_TCC__
@@ -6,15 +6,24 @@
 #define __ZETH_CIRCUITS_CIRCUIT_WRAPPER_HPP__
 
 #include "libzeth/circuits/joinsplit.tcc"
+#include "libzeth/core/cancellation.hpp"
 #include "libzeth/core/extended_proof.hpp"
 #include "libzeth/core/note.hpp"
 #include "libzeth/zeth_constants.hpp"
 
+#include <memory>
+
 namespace libzeth
 {
 
 /// Wrapper around the joinsplit circuit, using parameterized schemes for
 /// hashing, and a snark scheme for generating keys and proofs.
+///
+/// The joinsplit gadget and its constraint system are built once, at
+/// construction time, and shared by all subsequent calls. Witnesses are
+/// generated in a separate `witness_context` (see below), so the wrapper
+/// itself is never modified after construction and may be shared between
+/// threads.
 template<
     typename HashT,
     typename HashTreeT,
@@ -25,28 +34,106 @@ template<
     size_t TreeDepth>
 class circuit_wrapper
 {
-private:
-    std::shared_ptr<joinsplit_gadget<
-        libff::Fr<ppT>,
+public:
+    using FieldT = libff::Fr<ppT>;
+
+    using joinsplit_gadget_t = joinsplit_gadget<
+        FieldT,
         HashT,
         HashTreeT,
         NumInputs,
         NumOutputs,
-        TreeDepth>>
-        joinsplit_g;
+        TreeDepth>;
 
-public:
-    using FieldT = libff::Fr<ppT>;
+    /// Protoboard and joinsplit gadget in which a witness is generated. A
+    /// context allocates the variables of the circuit but not its
+    /// constraints (held once, by the wrapper), so it is cheap enough for
+    /// each thread generating witnesses to use its own. A context must not be
+    /// used by several threads at the same time.
+    class witness_context
+    {
+    public:
+        witness_context();
+
+        // The gadget holds a reference to `pb`.
+        witness_context(const witness_context &) = delete;
+        witness_context &operator=(const witness_context &) = delete;
+
+        // Retrieve the protoboard (intended for debugging purposes).
+        const libsnark::protoboard<FieldT> &get_protoboard() const;
+
+    private:
+        friend class circuit_wrapper;
+
+        libsnark::protoboard<FieldT> pb;
+        std::unique_ptr<joinsplit_gadget_t> joinsplit_g;
+    };
+
+private:
+    // Protoboard holding the (fixed) constraint system of the joinsplit
+    // circuit. Its variable assignment is never written.
+    libsnark::protoboard<FieldT> pb;
+
+    // The constraints of `pb`, against which witnesses are checked. The
+    // protoboard only returns them by value, so they are copied once here
+    // rather than on every check.
+    libsnark::r1cs_constraint_system<FieldT> constraint_system;
 
+public:
     circuit_wrapper();
 
+    // The wrapper holds the whole constraint system, so it is not copied.
+    circuit_wrapper(const circuit_wrapper &) = delete;
+    circuit_wrapper &operator=(const circuit_wrapper &) = delete;
+
     // Generate the trusted setup
     typename snarkT::KeypairT generate_trusted_setup() const;
 
-    // Retrieve the constraint system (intended for debugging purposes).
-    libsnark::protoboard<FieldT> get_constraint_system() const;
+    // Retrieve the protoboard holding the constraint system (intended for
+    // debugging purposes).
+    const libsnark::protoboard<FieldT> &get_protoboard() const;
+
+    // Retrieve the constraint system.
+    const libsnark::r1cs_constraint_system<FieldT> &get_constraint_system()
+        const;
+
+    // Compute the witness (primary and auxiliary inputs) for the given
+    // joinsplit, in `context`. This is the (mostly single-threaded) first
+    // half of `prove`, and may run concurrently with other calls using other
+    // contexts, and with `prove_from_witness`. If `check_satisfiability` is
+    // set, the witness is checked against every constraint (which roughly
+    // doubles the cost of witness generation), and `std::invalid_argument`
+    // is thrown if it is invalid.
+    void generate_witness(
+        const std::array<FieldT, NumInputs> &roots,
+        const std::array<joinsplit_input<FieldT, TreeDepth>, NumInputs> &inputs,
+        const std::array<zeth_note, NumOutputs> &outputs,
+        const bits64 &vpub_in,
+        const bits64 &vpub_out,
+        const bits256 &h_sig_in,
+        const bits256 &phi_in,
+        witness_context &context,
+        bool check_satisfiability,
+        libsnark::r1cs_primary_input<FieldT> &primary_input,
+        libsnark::r1cs_auxiliary_input<FieldT> &auxiliary_input) const;
+
+    // Generate an extended proof from a witness computed by
+    // `generate_witness` (the multi-threaded second half of `prove`).
+    static extended_proof<ppT, snarkT> prove_from_witness(
+        const typename snarkT::ProvingKeyT &proving_key,
+        const libsnark::r1cs_primary_input<FieldT> &primary_input,
+        const libsnark::r1cs_auxiliary_input<FieldT> &auxiliary_input);
+
+    // As above, abandoning the proof generation (with `operation_cancelled`)
+    // if `cancellation` is cancelled before the proof is complete.
+    static extended_proof<ppT, snarkT> prove_from_witness(
+        const typename snarkT::ProvingKeyT &proving_key,
+        const libsnark::r1cs_primary_input<FieldT> &primary_input,
+        const libsnark::r1cs_auxiliary_input<FieldT> &auxiliary_input,
+        const cancellation_token &cancellation);
 
-    // Generate a proof and returns an extended proof
+    // Generate a proof and returns an extended proof, using a temporary
+    // witness context. `check_satisfiability` is as for `generate_witness`.
     extended_proof<ppT, snarkT> prove(
         const std::array<FieldT, NumInputs> &roots,
         const std::array<joinsplit_input<FieldT, TreeDepth>, NumInputs> &inputs,
@@ -55,7 +142,8 @@ public:
         const bits64 &vpub_out,
         const bits256 &h_sig_in,
         const bits256 &phi_in,
-        const typename snarkT::ProvingKeyT &proving_key) const;
+        const typename snarkT::ProvingKeyT &proving_key,
+        bool check_satisfiability = false) const;
 };
 
 } // namespace libzeth
@@ -27,6 +27,55 @@ circuit_wrapper<
     NumOutputs,
     TreeDepth>::circuit_wrapper()
 {
+    // Build the circuit and its constraints once. All proofs generated by
+    // this wrapper share the resulting constraint system. The gadget itself
+    // is only needed to generate the constraints.
+    joinsplit_gadget_t joinsplit_g(pb);
+    joinsplit_g.generate_r1cs_constraints();
+    constraint_system = pb.get_constraint_system();
+}
+
+template<
+    typename HashT,
+    typename HashTreeT,
+    typename ppT,
+    typename snarkT,
+    size_t NumInputs,
+    size_t NumOutputs,
+    size_t TreeDepth>
+circuit_wrapper<
+    HashT,
+    HashTreeT,
+    ppT,
+    snarkT,
+    NumInputs,
+    NumOutputs,
+    TreeDepth>::witness_context::witness_context()
+{
+    // Allocating the variables is enough to generate a witness: none of the
+    // gadgets allocate variables when generating their constraints, so the
+    // layout matches that of the wrapper's protoboard.
+    joinsplit_g.reset(new joinsplit_gadget_t(pb));
+}
+
+template<
+    typename HashT,
+    typename HashTreeT,
+    typename ppT,
+    typename snarkT,
+    size_t NumInputs,
+    size_t NumOutputs,
+    size_t TreeDepth>
+const libsnark::protoboard<libff::Fr<ppT>> &circuit_wrapper<
+    HashT,
+    HashTreeT,
+    ppT,
+    snarkT,
+    NumInputs,
+    NumOutputs,
+    TreeDepth>::witness_context::get_protoboard() const
+{
+    return pb;
 }
 
 template<
@@ -46,11 +95,6 @@ typename snarkT::KeypairT circuit_wrapper<
     NumOutputs,
     TreeDepth>::generate_trusted_setup() const
 {
-    libsnark::protoboard<FieldT> pb;
-    joinsplit_gadget<FieldT, HashT, HashTreeT, NumInputs, NumOutputs, TreeDepth>
-        g(pb);
-    g.generate_r1cs_constraints();
-
     // Generate a verification and proving key (trusted setup) and write them
     // in a file
     return snarkT::generate_setup(pb);
@@ -64,19 +108,15 @@ template<
     size_t NumInputs,
     size_t NumOutputs,
     size_t TreeDepth>
-libsnark::protoboard<libff::Fr<ppT>> circuit_wrapper<
+const libsnark::protoboard<libff::Fr<ppT>> &circuit_wrapper<
     HashT,
     HashTreeT,
     ppT,
     snarkT,
     NumInputs,
     NumOutputs,
-    TreeDepth>::get_constraint_system() const
+    TreeDepth>::get_protoboard() const
 {
-    libsnark::protoboard<FieldT> pb;
-    joinsplit_gadget<FieldT, HashT, HashTreeT, NumInputs, NumOutputs, TreeDepth>
-        g(pb);
-    g.generate_r1cs_constraints();
     return pb;
 }
 
@@ -88,7 +128,27 @@ template<
     size_t NumInputs,
     size_t NumOutputs,
     size_t TreeDepth>
-extended_proof<ppT, snarkT> circuit_wrapper<
+const libsnark::r1cs_constraint_system<libff::Fr<ppT>> &circuit_wrapper<
+    HashT,
+    HashTreeT,
+    ppT,
+    snarkT,
+    NumInputs,
+    NumOutputs,
+    TreeDepth>::get_constraint_system() const
+{
+    return constraint_system;
+}
+
+template<
+    typename HashT,
+    typename HashTreeT,
+    typename ppT,
+    typename snarkT,
+    size_t NumInputs,
+    size_t NumOutputs,
+    size_t TreeDepth>
+void circuit_wrapper<
     HashT,
     HashTreeT,
     ppT,
@@ -96,7 +156,7 @@ extended_proof<ppT, snarkT> circuit_wrapper<
     NumInputs,
     NumOutputs,
     TreeDepth>::
-    prove(
+    generate_witness(
         const std::array<FieldT, NumInputs> &roots,
         const std::array<joinsplit_input<FieldT, TreeDepth>, NumInputs> &inputs,
         const std::array<zeth_note, NumOutputs> &outputs,
@@ -104,7 +164,10 @@ extended_proof<ppT, snarkT> circuit_wrapper<
         const bits64 &vpub_out,
         const bits256 &h_sig_in,
         const bits256 &phi_in,
-        const typename snarkT::ProvingKeyT &proving_key) const
+        witness_context &context,
+        bool check_satisfiability,
+        libsnark::r1cs_primary_input<FieldT> &primary_input,
+        libsnark::r1cs_auxiliary_input<FieldT> &auxiliary_input) const
 {
     // left hand side and right hand side of the joinsplit
     bits64 lhs_value = vpub_in;
@@ -128,28 +191,119 @@ extended_proof<ppT, snarkT> circuit_wrapper<
         throw std::invalid_argument("invalid joinsplit balance");
     }
 
-    libsnark::protoboard<FieldT> pb;
-
-    joinsplit_gadget<FieldT, HashT, HashTreeT, NumInputs, NumOutputs, TreeDepth>
-        g(pb);
-    g.generate_r1cs_constraints();
-    g.generate_r1cs_witness(
+    // The assignment is copied out of the context, so that the context can
+    // be reused while the proof is generated from the copy.
+    context.joinsplit_g->generate_r1cs_witness(
         roots, inputs, outputs, vpub_in, vpub_out, h_sig_in, phi_in);
+    primary_input = context.pb.primary_input();
+    auxiliary_input = context.pb.auxiliary_input();
 
-    bool is_valid_witness = pb.is_satisfied();
-    std::cout << "******* [DEBUG] Satisfiability result: " << is_valid_witness
-              << " *******" << std::endl;
+    if (check_satisfiability &&
+        !constraint_system.is_satisfied(primary_input, auxiliary_input)) {
+        throw std::invalid_argument(
+            "witness does not satisfy the joinsplit constraints");
+    }
+}
 
-    typename snarkT::ProofT proof = snarkT::generate_proof(pb, proving_key);
-    libsnark::r1cs_primary_input<libff::Fr<ppT>> primary_input =
-        pb.primary_input();
+template<
+    typename HashT,
+    typename HashTreeT,
+    typename ppT,
+    typename snarkT,
+    size_t NumInputs,
+    size_t NumOutputs,
+    size_t TreeDepth>
+extended_proof<ppT, snarkT> circuit_wrapper<
+    HashT,
+    HashTreeT,
+    ppT,
+    snarkT,
+    NumInputs,
+    NumOutputs,
+    TreeDepth>::
+    prove_from_witness(
+        const typename snarkT::ProvingKeyT &proving_key,
+        const libsnark::r1cs_primary_input<FieldT> &primary_input,
+        const libsnark::r1cs_auxiliary_input<FieldT> &auxiliary_input)
+{
+    typename snarkT::ProofT proof =
+        snarkT::generate_proof(proving_key, primary_input, auxiliary_input);
 
     // Instantiate an extended_proof from the proof we generated and the given
     // primary_input
-    extended_proof<ppT, snarkT> ext_proof =
-        extended_proof<ppT, snarkT>(proof, primary_input);
+    return extended_proof<ppT, snarkT>(proof, primary_input);
+}
 
-    return ext_proof;
+template<
+    typename HashT,
+    typename HashTreeT,
+    typename ppT,
+    typename snarkT,
+    size_t NumInputs,
+    size_t NumOutputs,
+    size_t TreeDepth>
+extended_proof<ppT, snarkT> circuit_wrapper<
+    HashT,
+    HashTreeT,
+    ppT,
+    snarkT,
+    NumInputs,
+    NumOutputs,
+    TreeDepth>::
+    prove_from_witness(
+        const typename snarkT::ProvingKeyT &proving_key,
+        const libsnark::r1cs_primary_input<FieldT> &primary_input,
+        const libsnark::r1cs_auxiliary_input<FieldT> &auxiliary_input,
+        const cancellation_token &cancellation)
+{
+    typename snarkT::ProofT proof = snarkT::generate_proof(
+        proving_key, primary_input, auxiliary_input, cancellation);
+    return extended_proof<ppT, snarkT>(proof, primary_input);
+}
+
+template<
+    typename HashT,
+    typename HashTreeT,
+    typename ppT,
+    typename snarkT,
+    size_t NumInputs,
+    size_t NumOutputs,
+    size_t TreeDepth>
+extended_proof<ppT, snarkT> circuit_wrapper<
+    HashT,
+    HashTreeT,
+    ppT,
+    snarkT,
+    NumInputs,
+    NumOutputs,
+    TreeDepth>::
+    prove(
+        const std::array<FieldT, NumInputs> &roots,
+        const std::array<joinsplit_input<FieldT, TreeDepth>, NumInputs> &inputs,
+        const std::array<zeth_note, NumOutputs> &outputs,
+        const bits64 &vpub_in,
+        const bits64 &vpub_out,
+        const bits256 &h_sig_in,
+        const bits256 &phi_in,
+        const typename snarkT::ProvingKeyT &proving_key,
+        bool check_satisfiability) const
+{
+    witness_context context;
+    libsnark::r1cs_primary_input<FieldT> primary_input;
+    libsnark::r1cs_auxiliary_input<FieldT> auxiliary_input;
+    generate_witness(
+        roots,
+        inputs,
+        outputs,
+        vpub_in,
+        vpub_out,
+        h_sig_in,
+        phi_in,
+        context,
+        check_satisfiability,
+        primary_input,
+        auxiliary_input);
+    return prove_from_witness(proving_key, primary_input, auxiliary_input);
 }
 
 } // namespace libzeth
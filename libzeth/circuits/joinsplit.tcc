@@ -12,6 +12,7 @@
 #include "libzeth/zeth_constants.hpp"
 
 #include <boost/static_assert.hpp>
+#include <exception>
 
 namespace libzeth
 {
@@ -480,6 +481,9 @@ public:
         }
     }
 
+    // If `parallel` is set (and the build has MULTICORE enabled), the input
+    // and output notes are witnessed concurrently. The resulting assignment
+    // is the same in both cases.
     void generate_r1cs_witness(
         const std::array<FieldT, NumInputs> &rt,
         const std::array<joinsplit_input<FieldT, TreeDepth>, NumInputs> &inputs,
@@ -487,7 +491,8 @@ public:
         bits64 vpub_in,
         bits64 vpub_out,
         const bits256 h_sig_in,
-        const bits256 phi_in)
+        const bits256 phi_in,
+        const bool parallel = true)
     {
         // Witness `zero`
         this->pb.val(ZERO) = FieldT::zero();
@@ -535,21 +540,33 @@ public:
                 this->pb, bits64_to_vector(left_side_acc));
         }
 
-        // Witness the JoinSplit inputs and the h_is
-        for (size_t i = 0; i < NumInputs; i++) {
-            std::vector<FieldT> merkle_path = inputs[i].witness_merkle_path;
-            libff::bit_vector address_bits =
-                bits_addr_to_vector(inputs[i].address_bits);
-            input_notes[i]->generate_r1cs_witness(
-                merkle_path, address_bits, inputs[i].note);
-
-            h_i_gadgets[i]->generate_r1cs_witness();
+        // Witness the JoinSplit inputs (with their h_i) and outputs (with
+        // their rho_i). The gadgets of each note only read the variables
+        // witnessed above, and write a disjoint set of variables, so the notes
+        // can be witnessed concurrently. Exceptions are caught per note and
+        // rethrown (in order) outside of the parallel region.
+        std::array<std::exception_ptr, NumInputs + NumOutputs> errors;
+#ifdef MULTICORE
+#pragma omp parallel for if (parallel)
+#else
+        (void)parallel;
+#endif
+        for (size_t j = 0; j < NumInputs + NumOutputs; j++) {
+            try {
+                if (j < NumInputs) {
+                    generate_input_note_witness(j, inputs[j]);
+                } else {
+                    generate_output_note_witness(
+                        j - NumInputs, outputs[j - NumInputs]);
+                }
+            } catch (...) {
+                errors[j] = std::current_exception();
+            }
         }
-
-        // Witness the JoinSplit outputs
-        for (size_t i = 0; i < NumOutputs; i++) {
-            rho_i_gadgets[i]->generate_r1cs_witness();
-            output_notes[i]->generate_r1cs_witness(outputs[i]);
+        for (const std::exception_ptr &error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
         }
 
         // This happens last, because only by now are all the
@@ -647,6 +664,26 @@ public:
 
         return nb_elements;
     }
+
+private:
+    // Witness the gadgets of the i-th input note, and its h_i
+    void generate_input_note_witness(
+        size_t i, const joinsplit_input<FieldT, TreeDepth> &input)
+    {
+        const libff::bit_vector address_bits =
+            bits_addr_to_vector(input.address_bits);
+        input_notes[i]->generate_r1cs_witness(
+            input.witness_merkle_path, address_bits, input.note);
+
+        h_i_gadgets[i]->generate_r1cs_witness();
+    }
+
+    // Witness the rho of the i-th output note, and then the note itself
+    void generate_output_note_witness(size_t i, const zeth_note &output)
+    {
+        rho_i_gadgets[i]->generate_r1cs_witness();
+        output_notes[i]->generate_r1cs_witness(output);
+    }
 };
 
 } // namespace libzeth
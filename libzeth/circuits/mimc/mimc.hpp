@@ -5,6 +5,7 @@
 #ifndef __ZETH_CIRCUITS_MIMC_HPP__
 #define __ZETH_CIRCUITS_MIMC_HPP__
 
+#include "libzeth/circuits/mimc/mimc_native.hpp"
 #include "libzeth/circuits/mimc/mimc_round.hpp"
 
 // MiMCe7_permutation_gadget enforces correct computation of a MiMC permutation
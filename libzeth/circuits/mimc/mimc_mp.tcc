@@ -59,30 +59,12 @@ const libsnark::pb_variable<FieldT> &MiMC_mp_gadget<FieldT>::result() const
     return output;
 }
 
-// Returns the hash of two elements
+// Returns the hash of two elements. This uses the native implementation,
+// which computes the same value as the gadget without a protoboard.
 template<typename FieldT>
 FieldT MiMC_mp_gadget<FieldT>::get_hash(const FieldT x, FieldT y)
 {
-    libsnark::protoboard<FieldT> pb;
-
-    libsnark::pb_variable<FieldT> pb_x;
-    libsnark::pb_variable<FieldT> pb_y;
-
-    // Allocates and fill with the x and y
-    pb_x.allocate(pb, " x");
-    pb.val(pb_x) = x;
-
-    pb_y.allocate(pb, " y");
-    pb.val(pb_y) = y;
-
-    // Initialize the Hash
-    MiMC_mp_gadget<FieldT> mimc_hasher(pb, pb_x, pb_y, " mimc_hash");
-
-    // Computes the hash
-    mimc_hasher.generate_r1cs_witness();
-
-    // Returns the hash
-    return pb.val(mimc_hasher.result());
+    return MiMC_mp<FieldT>::get_hash(x, y);
 }
 
 } // namespace libzeth
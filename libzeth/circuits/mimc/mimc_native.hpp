@@ -0,0 +1,47 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_CIRCUITS_MIMC_NATIVE_HPP__
+#define __ZETH_CIRCUITS_MIMC_NATIVE_HPP__
+
+#include <cstddef>
+#include <vector>
+
+// Native (out-of-circuit) implementations of the MiMCe7 permutation and of
+// the MiMC_mp compression function. These compute the same values as
+// MiMCe7_permutation_gadget and MiMC_mp_gadget, directly on field elements,
+// without building a protoboard.
+
+namespace libzeth
+{
+
+template<typename FieldT> class MiMCe7_permutation
+{
+public:
+    // Nb of rounds suggested by the MiMC paper
+    static const size_t ROUNDS = 91;
+
+    // Round constants, computed once and shared by all callers (including
+    // the gadgets).
+    static const std::vector<FieldT> &round_constants();
+
+    // Encrypt the message x with the key k
+    static FieldT permute(const FieldT &x, const FieldT &k);
+
+private:
+    static std::vector<FieldT> compute_round_constants();
+};
+
+template<typename FieldT> class MiMC_mp
+{
+public:
+    // Returns the hash of two elements
+    static FieldT get_hash(const FieldT &x, const FieldT &y);
+};
+
+} // namespace libzeth
+
+#include "libzeth/circuits/mimc/mimc_native.tcc"
+
+#endif // __ZETH_CIRCUITS_MIMC_NATIVE_HPP__
@@ -0,0 +1,196 @@
+#ifndef __ZETH_CIRCUITS_POSEIDON_CONSTANTS_HPP_
+#define __ZETH_CIRCUITS_POSEIDON_CONSTANTS_HPP_
+
+// Copyright (c) 2019 xxb
+// License: LGPL-3.0+
+
+// Round constants and mixing matrix of the Poseidon permutation, shared by
+// the gadget (poseidon.hpp) and the native implementation
+// (poseidon_native.hpp).
+
+#include "libzeth/circuits/poseidon/blake2b.hpp"
+#include "libzeth/circuits/poseidon/poseidon_constants_alt_bn128.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <gmp.h>
+#include <libff/algebra/curves/alt_bn128/alt_bn128_init.hpp>
+#include <libff/algebra/fields/bigint.hpp>
+#include <string>
+#include <vector>
+
+namespace libzeth
+{
+
+template<typename FieldT> struct PoseidonConstants {
+    std::vector<FieldT> C; // `t` constants
+    std::vector<FieldT> M; // `t * t` matrix of constants
+};
+
+template<typename FieldT>
+static FieldT bytes_to_FieldT(
+    const uint8_t *in_bytes, const size_t in_count, int order)
+{
+    const unsigned n_bits_roundedup =
+        FieldT::size_in_bits() + (8 - (FieldT::size_in_bits() % 8));
+    const unsigned n_bytes = n_bits_roundedup / 8;
+
+    assert(in_count <= n_bytes);
+
+    // Import bytes as big-endian
+    mpz_t result_as_num;
+    mpz_init(result_as_num);
+    mpz_import(
+        result_as_num, // rop
+        in_count,      // count
+        order,         // order
+        1,             // size
+        0,             // endian
+        0,             // nails
+        in_bytes);     // op
+
+    // Convert to bigint, within F_p
+    libff::bigint<FieldT::num_limbs> item(result_as_num);
+    assert(sizeof(item.data) == n_bytes);
+    mpz_clear(result_as_num);
+
+    return FieldT(item);
+}
+
+template<typename FieldT>
+FieldT bytes_to_FieldT_littleendian(
+    const uint8_t *in_bytes, const size_t in_count)
+{
+    return bytes_to_FieldT<FieldT>(in_bytes, in_count, -1);
+}
+
+template<typename FieldT>
+static void poseidon_constants_fill(
+    const std::string &seed, unsigned n_constants, std::vector<FieldT> &result)
+{
+    blake2b_ctx ctx;
+
+    const unsigned n_bits_roundedup =
+        FieldT::size_in_bits() + (8 - (FieldT::size_in_bits() % 8));
+    const unsigned output_size = n_bits_roundedup / 8;
+    uint8_t output[output_size];
+
+    result.reserve(n_constants);
+
+    blake2b(output, output_size, NULL, 0, seed.c_str(), seed.size());
+    result.emplace_back(
+        bytes_to_FieldT_littleendian<FieldT>(output, output_size));
+
+    for (unsigned i = 0; i < (n_constants - 1); i++) {
+        blake2b(output, output_size, NULL, 0, output, output_size);
+        result.emplace_back(
+            bytes_to_FieldT_littleendian<FieldT>(output, output_size));
+    }
+}
+
+template<typename FieldT>
+static const std::vector<FieldT> poseidon_constants(
+    const std::string &seed, unsigned n_constants)
+{
+    std::vector<FieldT> result;
+    poseidon_constants_fill(seed, n_constants, result);
+    return result;
+}
+
+template<typename FieldT>
+static void poseidon_matrix_fill(
+    const std::string &seed, unsigned t, std::vector<FieldT> &result)
+{
+    const std::vector<FieldT> c = poseidon_constants<FieldT>(seed, t * 2);
+
+    result.reserve(t * 2);
+
+    for (unsigned i = 0; i < t; i++) {
+        for (unsigned j = 0; j < t; j++) {
+            result.emplace_back((c[i] - c[t + j]).inverse());
+        }
+    }
+}
+
+template<typename FieldT>
+static const std::vector<FieldT> poseidon_matrix(
+    const std::string &seed, unsigned t)
+{
+    std::vector<FieldT> result;
+    poseidon_matrix_fill(seed, t, result);
+    return result;
+}
+
+// Derive the constants at run time (BLAKE2b chain, and one inversion per
+// matrix entry). Only used for fields and parameters without precomputed
+// constants.
+template<unsigned param_t, unsigned param_F, unsigned param_P, typename FieldT>
+PoseidonConstants<FieldT> poseidon_derive_params()
+{
+    PoseidonConstants<FieldT> constants;
+    poseidon_constants_fill<FieldT>(
+        "poseidon_constants", param_F + param_P, constants.C);
+    poseidon_matrix_fill("poseidon_matrix_0000", param_t, constants.M);
+    return constants;
+}
+
+// Set `result` from values given in Montgomery form, as 64-bit limbs.
+template<typename FieldT, size_t n_values, size_t n_limbs>
+void poseidon_fill_from_montgomery_limbs(
+    const uint64_t (&limbs)[n_values][n_limbs], std::vector<FieldT> &result)
+{
+    static_assert(
+        FieldT::num_limbs == n_limbs && sizeof(mp_limb_t) == sizeof(uint64_t),
+        "limbs do not match the field representation");
+    result.resize(n_values);
+    for (size_t i = 0; i < n_values; ++i) {
+        for (size_t j = 0; j < n_limbs; ++j) {
+            result[i].mont_repr.data[j] = limbs[i][j];
+        }
+    }
+}
+
+// Constants generated by poseidon_constants_generation.py, for the
+// parameters and fields listed below. `fill` returns false otherwise.
+template<unsigned param_t, unsigned param_F, unsigned param_P, typename FieldT>
+struct poseidon_precomputed_params {
+    static bool fill(PoseidonConstants<FieldT> &) { return false; }
+};
+
+#if GMP_NUMB_BITS == 64
+template<> struct poseidon_precomputed_params<6, 8, 57, libff::alt_bn128_Fr> {
+    static bool fill(PoseidonConstants<libff::alt_bn128_Fr> &constants)
+    {
+        poseidon_fill_from_montgomery_limbs(
+            poseidon128_alt_bn128_C, constants.C);
+        poseidon_fill_from_montgomery_limbs(
+            poseidon128_alt_bn128_M, constants.M);
+        return true;
+    }
+};
+#endif
+
+template<unsigned param_t, unsigned param_F, unsigned param_P, typename FieldT>
+PoseidonConstants<FieldT> poseidon_load_params()
+{
+    PoseidonConstants<FieldT> constants;
+    if (poseidon_precomputed_params<param_t, param_F, param_P, FieldT>::fill(
+            constants)) {
+        return constants;
+    }
+    return poseidon_derive_params<param_t, param_F, param_P, FieldT>();
+}
+
+// Constants for the given parameters, loaded once (the initialization of the
+// local static is thread-safe).
+template<unsigned param_t, unsigned param_F, unsigned param_P, typename FieldT>
+const PoseidonConstants<FieldT> &poseidon_params()
+{
+    static const PoseidonConstants<FieldT> constants =
+        poseidon_load_params<param_t, param_F, param_P, FieldT>();
+    return constants;
+}
+
+} // namespace libzeth
+
+#endif // __ZETH_CIRCUITS_POSEIDON_CONSTANTS_HPP_
@@ -0,0 +1,433 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+// Generated by poseidon_constants_generation.py. Do not edit.
+
+#ifndef __ZETH_CIRCUITS_POSEIDON_CONSTANTS_ALT_BN128_HPP__
+#define __ZETH_CIRCUITS_POSEIDON_CONSTANTS_ALT_BN128_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+// Constants of Poseidon128 (t = 6, F = 8, P = 57) over the scalar field of
+// alt_bn128, in Montgomery form (R = 2^256), as 64-bit limbs (least
+// significant first). `C` holds one constant per round, and `M` is the
+// t x t MDS matrix in row-major order.
+
+namespace libzeth
+{
+
+static constexpr uint64_t poseidon128_alt_bn128_C[65][4] = {
+    {0xf305ba9cb9636423,
+     0x35a29cdfadef0b0b,
+     0xa50f03af897b61fd,
+     0x071d2b0a58ba4c96},
+    {0x715c102862a7c054,
+     0x48968f2add0f4908,
+     0xe3af103abc57fc13,
+     0x0bdc70f3eb5ee36e},
+    {0x940ecd6d69c114bc,
+     0x074622cbda8b15d7,
+     0xd644bac48bb17d72,
+     0x179f154344e573a4},
+    {0x87114797eaf23695,
+     0x7de45b60626db66f,
+     0xe3e76182c6b7098f,
+     0x0d622ca13bf10067},
+    {0x9afb27b5a5e5a371,
+     0x2310230843a775c0,
+     0x5ae9345367aee9e1,
+     0x174d85de81b00505},
+    {0x530f4620de134271,
+     0xf7eb154bc8393b21,
+     0xa51ce56f92e0c834,
+     0x19643aef53956854},
+    {0x4915c38a114972b8,
+     0x86b090cb5b891577,
+     0xdbadd51d658d6f90,
+     0x275162a79b26b12a},
+    {0x07625f85576a9d0f,
+     0xae9916a3d7ccb4cc,
+     0xf83b53b54a1c6ae6,
+     0x1a1bf7526caa666f},
+    {0x62919b0976b9878d,
+     0x427f3f8ae061e17f,
+     0xe33de032be8c7565,
+     0x111bec769d568ff1},
+    {0xf217231a8a846eb7,
+     0x3428a1e1423c20ac,
+     0x4422c03a96c8af5d,
+     0x246a46d9a7f94246},
+    {0x4277da953ce9dbfa,
+     0xf78bbea010f8f716,
+     0xef6abc9a6b1538c3,
+     0x228396d1675cd847},
+    {0x751e37f421d8bede,
+     0x40adf92e19d706ef,
+     0x6a1547f63a63a1ef,
+     0x234a98d4cd05d102},
+    {0xc326badced7773f1,
+     0xab555806c7205616,
+     0x08b882e196620535,
+     0x176d2f676ccc9884},
+    {0x656be36c59506ca4,
+     0xc66bff14021591fd,
+     0xb1d0f4c1a428eb79,
+     0x09e1cb54a76dd5bf},
+    {0x8637e4db4d12140c,
+     0x6e0a6b05b810b6f0,
+     0x97d5c5243af47f46,
+     0x240974a8ef21f52a},
+    {0xf27a396fd052f968,
+     0xe6f9ce5cc91f9cba,
+     0xc97a8914ac510c0a,
+     0x00ea6f983192df35},
+    {0xd9c6749a0de61c12,
+     0xb9427debaff4a72d,
+     0x8d7ded3db36e3156,
+     0x237f93f612e3de5f},
+    {0x02771531dc1d9d77,
+     0xa26448d4cba77ac5,
+     0x984478270f217e43,
+     0x16b162ba25fc2876},
+    {0x30a811f91721154b,
+     0xa6c0818a7ddd35d2,
+     0x78350ef35a20f284,
+     0x1535632e042a655c},
+    {0x6b0d0ae1d5c9ff85,
+     0xac41444af529d615,
+     0x9ffe19f6ba5a0dcb,
+     0x2aa0301a7a1f458e},
+    {0x1c26360cf278b36c,
+     0x3eed5875303678f6,
+     0xe8f3f261a768b529,
+     0x24d148ac85522955},
+    {0x02df5e59a99c9418,
+     0xc552650af096e0a9,
+     0x4216fc2f6610d7ce,
+     0x2661bd34df7268df},
+    {0x9c6de042ac1142db,
+     0x6c487233432ab56f,
+     0x063e9cbd75f6d727,
+     0x0322a4f42b1fffd5},
+    {0x67c2b916a595b59b,
+     0x15de5e6894c02877,
+     0xac3db1912739e0e1,
+     0x27d64afa0e5ef22e},
+    {0xcd99c171735fb7ea,
+     0xdd7f3911e36639f3,
+     0x9e495f988772e42e,
+     0x0a44eb7a340e7225},
+    {0xbb093a64f828e9fe,
+     0x38904603ca44f28c,
+     0x94ebef1fec9a4b81,
+     0x2629d4df66ab2be4},
+    {0x1fee4fc1ade89b8c,
+     0x858db168875830d1,
+     0x7b98f3eb622d5a49,
+     0x27590ab5aedf0d73},
+    {0xbb80059daa4edd6b,
+     0x55c2f3f4e9446d58,
+     0xa2ea22b8c9663ef5,
+     0x10e3df792435b779},
+    {0x82c7d8c9e9f3eaae,
+     0xcf133bc45a1ad2c5,
+     0xdc499e262dcf7521,
+     0x2a2aaaef7173064d},
+    {0x7157627d8573cd11,
+     0x5043b0c68e3abd1f,
+     0xa24d96888cef0f15,
+     0x1a9dc3c7615e7f08},
+    {0xd0914077716afd52,
+     0x4fcbe11c3bcad39f,
+     0x914749934148c9f3,
+     0x04159ded57b96d65},
+    {0x180ffea776bc8666,
+     0xc534915e39ea9f40,
+     0x453fa31443753682,
+     0x2aecb2d11761dfcf},
+    {0x91c36b4d8110e928,
+     0x3d1b238230fd039b,
+     0xee47f8568969a48a,
+     0x26c8fc728039f9a7},
+    {0x4f1486660f4ab3d4,
+     0xccdb962bb101f411,
+     0x5cf100a6e2cc437c,
+     0x10783c938270e4bf},
+    {0xe6101f982195ba8b,
+     0xccd71839229aaf54,
+     0xf34042f14ec792d7,
+     0x1f05059bbcd74fe5},
+    {0xa4d30387898e8c9e,
+     0x6e60e747b7ca9d66,
+     0x46b131b659d36253,
+     0x2ea528e1d4f2433d},
+    {0x8170c2c07ad25121,
+     0x4ab7070cfc8b3ec6,
+     0x4ec3206ce0318fdf,
+     0x02b3dbe03e8ab9a0},
+    {0x674f9c91b9344b77,
+     0x91c0b9b458b714a7,
+     0x30e8a619a194d07f,
+     0x10509aa7f6fb9748},
+    {0x3d4db9e85a3a33e5,
+     0xef381c503d9c40c1,
+     0x1670e6950c488a8d,
+     0x0d6dbb88ce765d14},
+    {0x4d069730fdb9c0d5,
+     0x6b03197ce7360313,
+     0xa285e906150d8b1e,
+     0x1628d5d8f22c3eba},
+    {0xf3c5f41cc1ac2cc0,
+     0x3c89b34cb8dfdce1,
+     0x510bd2ab3d21d912,
+     0x196cbfe2333f0d88},
+    {0x77b338b86ef3c619,
+     0xbb6c3d7842396947,
+     0x5e11fc3a3648884d,
+     0x2fda5e4742c0b0c4},
+    {0xee32ccbb9ef7d5e2,
+     0x798fd6d31ed0e8e1,
+     0xc1675935235cbad6,
+     0x0e398dfa4a2d2ba4},
+    {0xfc0dd228a7d8f3de,
+     0xcce2d80b7185d8c0,
+     0x82a7a396bac90677,
+     0x234aae35d18bfe0c},
+    {0x85fcacae2213ac54,
+     0xd3d002e924a184ab,
+     0x965f6a4d1ce16060,
+     0x0da9150a517c5b31},
+    {0xaa93407d518a02d4,
+     0x67b3e20e9723591d,
+     0xbaeebee8006f3d5c,
+     0x2ee764890e0f6035},
+    {0x042287f027fff008,
+     0x96ff56800e8a6c6d,
+     0x470463cfe048ed5b,
+     0x13b93b9d0b668856},
+    {0x9345ce166d7c2f6c,
+     0xe48c355fac3e3c15,
+     0x8f06426f6b762d6c,
+     0x05caf15976f2f5cc},
+    {0x58982ec88c4b99ed,
+     0xe77cdf05bed9a8fc,
+     0x09e133394e888db8,
+     0x06d3ca8724757727},
+    {0xd922d979cee94b4b,
+     0x7070f248ec8ac135,
+     0xa08285afe3d9b3c9,
+     0x1c98144750b407f6},
+    {0x5d790645682d60e6,
+     0x8e95785a03c74391,
+     0xdb295fb1c6901eab,
+     0x102f44f49549ec9a},
+    {0xefe5398ef410c32e,
+     0x5202ee6373a211ca,
+     0x6bbeca3d7aca9abf,
+     0x20e0bc40dc14c6ea},
+    {0x3e39d5fb74a20f55,
+     0x91a07fd3a6968f25,
+     0xa984918ae53756eb,
+     0x20bab57bf25c5e47},
+    {0xdf6c8ad0f44be36a,
+     0x69c1fd3f2bd9e2fb,
+     0x50880c1f18c94d80,
+     0x2dc077df9b89cc16},
+    {0x9f3515fa0620f6a0,
+     0x9fcdf8f582873478,
+     0x777a43124a000c5a,
+     0x148e73205df17850},
+    {0xb873e47b8ef34d9b,
+     0x58b20306c0d9db58,
+     0xd575a2aaf55d75e5,
+     0x2fbdcd3c8d42bbff},
+    {0xbd42ec6f43a54d29,
+     0xa39160da1bfd4de3,
+     0x6cba306b84d4e5d7,
+     0x2fd1a0c6a635e189},
+    {0x37553faed8fdd870,
+     0x1204cfd0edd971eb,
+     0x9884e09320a46026,
+     0x155917e3ee9c3fb6},
+    {0x620e94117a7f1cd7,
+     0x37152fc5ce05022e,
+     0x28f5d99bbaf59ba5,
+     0x1663e6c725538a59},
+    {0xe837977e315d8132,
+     0x69c05d0d6763e8aa,
+     0x18f3ca6e8e144360,
+     0x2ccef0671962ebd6},
+    {0xe5f0d5bb41606a27,
+     0x6b2c0a734eb84666,
+     0xf9e8a1a004db2a32,
+     0x209db6dbc6b41916},
+    {0xb9f5f2b27fa3b78c,
+     0x6dc7591f0c929bc5,
+     0x4add747af458cb41,
+     0x20496ccd004d68bc},
+    {0xc442bdf5785215d1,
+     0xf17f1d521a78b1c6,
+     0x9413e4a4acf14fd7,
+     0x1738d0bc37bda044},
+    {0x4e9efd734faf158f,
+     0xb666f7ae21d79782,
+     0x78af30c92c006577,
+     0x21a620459c164bc5},
+    {0xe76379f014682019,
+     0xbd9b65fa064efd2b,
+     0x67d5b640d47f6094,
+     0x033c8b8c62f056d5},
+};
+
+static constexpr uint64_t poseidon128_alt_bn128_M[36][4] = {
+    {0x21d68f50cb74ac48,
+     0x3e0b049316304f38,
+     0x1dcda650dbc3e6de,
+     0x11f9d53cc0d1963e},
+    {0x2dc043d7f62c9284,
+     0x04110e8b84ddb033,
+     0x31fb4bb763925c05,
+     0x28e08139ee143e2a},
+    {0xdd68ee03ae7b7660,
+     0x4c170d7ed9768612,
+     0xe9f312295329c00e,
+     0x0014bc4b93fad7bc},
+    {0x753bddb62c974362,
+     0x0a633e46f6a87d23,
+     0x39c3da467ee32867,
+     0x0b4152555ce35db4},
+    {0x61196088d6379488,
+     0xaeab59a7528c0717,
+     0x63273630fb77cd09,
+     0x01aefe4cae15a4bc},
+    {0x877a4d4a187128dd,
+     0x10f00476303470a1,
+     0x963e13f75cb2fdce,
+     0x1f99ebf365887777},
+    {0xf73b92a9c0e4b612,
+     0x3dfba5bc1c3c2e89,
+     0x3696b65cc6bb9116,
+     0x218e1630d185fba8},
+    {0x241c6022e080aa4a,
+     0x819ce162d1959439,
+     0x44c98063a41e7f9d,
+     0x17eed2775df17ef1},
+    {0x7136ba31bd5a532a,
+     0x97fea0fe46873637,
+     0xdbc14024d806152d,
+     0x13e198c9ffdc0539},
+    {0x0b196b5c44f57c05,
+     0x87b67fefb48fa319,
+     0x272cf78246dbbfb8,
+     0x0fc54145d5f9493a},
+    {0xc159f9dc4fed289f,
+     0x5c611ecd67100dcb,
+     0xf2a03557e180c2a2,
+     0x2fde4f80c3db1378},
+    {0xfc2d82ef88a475fc,
+     0xc70dfe413d92de00,
+     0x4b1c9c1869fac500,
+     0x24a59f9be62f4905},
+    {0x69496a6f37455229,
+     0x99d25feefcb6c2f7,
+     0x5cf2fe166f4ad4c4,
+     0x2c1dfa4eea709cc5},
+    {0xf2f916c953f561f3,
+     0x65101eb845a6e870,
+     0x6fc1a720c4ae120f,
+     0x04d466a47d6fbd74},
+    {0x8a45aef8d23a97bf,
+     0xa97f75cfd63f689d,
+     0x2327a4a1bd9ee971,
+     0x0c33abc815a5f9af},
+    {0xa5a77cbdce74de26,
+     0x0a1e7b7959bb2e05,
+     0x488c542ca5eb91bb,
+     0x0a2fd5012fd2117a},
+    {0x2f7a179c15f1cf3c,
+     0xe694530222c9c495,
+     0x3b5ea9d74a3ce24a,
+     0x2145729ea6e450d2},
+    {0xe79d0277d42da3b6,
+     0xb866a0c7f8e5b9ca,
+     0x0b425f6f114fc5c1,
+     0x2e875673a02b2f80},
+    {0xc124c9a4b24bef7f,
+     0xeed23c36fa87277e,
+     0xf985df818e1162d4,
+     0x073f3f0f8f27bfe1},
+    {0x99ec0a305f4071c8,
+     0x0c3f20a470567b6c,
+     0x0c49ae1d8cb4423f,
+     0x063059c3da6a6e51},
+    {0xd54bded39ba6826a,
+     0xf9af1f3fbd823eb2,
+     0xcdab7763004ae035,
+     0x0a04e914b04e3ef2},
+    {0xd0380085e871c9b5,
+     0xbbd2c55149740ab4,
+     0x3d21cd933c1723da,
+     0x2bb589c839448c77},
+    {0xe586ba98b6ab7c31,
+     0x6df29addacb5247c,
+     0xf5ade20a3c949d64,
+     0x2ab6afbe3e1f2e2c},
+    {0xad4c3c22834de6a0,
+     0x981c9656f3375a8a,
+     0x161000b4384ff1b6,
+     0x0ce1d4ce7ca1b06e},
+    {0xa8a34329964a656e,
+     0x5d63ef107772fc57,
+     0x2225c7e080e80208,
+     0x2b6be511caf79895},
+    {0xe752d53f5d78e220,
+     0xa1912d23af62ac51,
+     0x3068eb0a2a01b91e,
+     0x2c2d6b768953d337},
+    {0x93678163b10524be,
+     0x4b188b04d7c11af1,
+     0x8047779659f026e8,
+     0x0cf1cb8023d548dc},
+    {0xedf5e6b8bf09a8a1,
+     0xa500e2e40a2229ee,
+     0x80551df584c7070e,
+     0x0e58e2f843ee9a62},
+    {0xed80f3fbabff3c10,
+     0xdf46be903753dcd0,
+     0x3652d361f6ff3d73,
+     0x19a80a07bd4b92b3},
+    {0x4c6aa65ce0a62083,
+     0xcdba556650a1da21,
+     0xb5a064314da9e1b2,
+     0x1f05832b21d96113},
+    {0xe3b1af9c4bd30c68,
+     0x78fd7c38ee9976fd,
+     0x695020853f333cd9,
+     0x09f5f229ee4c4dd9},
+    {0x88ea49fdc63b80a9,
+     0x0f3ecc464862aad3,
+     0x7bd47aa8117d12fb,
+     0x06e9c425d05e710b},
+    {0xfacb62ffa6d0867e,
+     0xf11548ad4cb3eab2,
+     0xb99ca21c99995d49,
+     0x1b73c51117b7d413},
+    {0x6d32c3888be29f6a,
+     0x90bcbb81fd6fd5c4,
+     0x292c44093859006d,
+     0x01bb5de65658fab0},
+    {0x64e48e9804e188f2,
+     0x93f9e51d9015e98f,
+     0xc57ccf4765d49542,
+     0x24f99372bb052c41},
+    {0x3190655383860cc9,
+     0xb08a67f13c9a157f,
+     0x16ff5a3a2c8331b4,
+     0x14dc5cc10c3b37b0},
+};
+
+} // namespace libzeth
+
+#endif // __ZETH_CIRCUITS_POSEIDON_CONSTANTS_ALT_BN128_HPP__
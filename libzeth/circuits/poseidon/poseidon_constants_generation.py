@@ -0,0 +1,97 @@
+# Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+#
+# SPDX-License-Identifier: LGPL-3.0+
+
+# Generates poseidon_constants_alt_bn128.hpp:
+#
+#   python3 poseidon_constants_generation.py > poseidon_constants_alt_bn128.hpp
+#
+# The constants are derived as in poseidon_derive_params (see
+# poseidon_constants.hpp): chained BLAKE2b-256 digests of a seed, read as
+# little-endian integers and reduced modulo the field characteristic. The MDS
+# matrix is the Cauchy matrix M[i][j] = 1 / (c[i] - c[t + j]). Values are
+# written in Montgomery form (R = 2^256), as 64-bit limbs (least significant
+# first), matching libff::alt_bn128_Fr::mont_repr.
+
+import hashlib
+
+# Scalar field of alt_bn128
+FIELD_MODULUS = \
+    21888242871839275222246405745257275088548364400416034343698204186575808495617
+NUM_LIMBS = 4
+LIMB_BITS = 64
+
+# Poseidon128 parameters: width, full rounds, partial rounds
+PARAM_T = 6
+PARAM_F = 8
+PARAM_P = 57
+
+
+def poseidon_constants(seed, n_constants):
+    digest = hashlib.blake2b(seed.encode('ascii'), digest_size=32).digest()
+    result = [int.from_bytes(digest, 'little') % FIELD_MODULUS]
+    for _ in range(n_constants - 1):
+        digest = hashlib.blake2b(digest, digest_size=32).digest()
+        result.append(int.from_bytes(digest, 'little') % FIELD_MODULUS)
+    return result
+
+
+def poseidon_matrix(seed, t):
+    c = poseidon_constants(seed, 2 * t)
+    return [
+        pow((c[i] - c[t + j]) % FIELD_MODULUS, FIELD_MODULUS - 2, FIELD_MODULUS)
+        for i in range(t) for j in range(t)]
+
+
+def montgomery_limbs(value):
+    mont = (value << (NUM_LIMBS * LIMB_BITS)) % FIELD_MODULUS
+    mask = (1 << LIMB_BITS) - 1
+    return [(mont >> (LIMB_BITS * i)) & mask for i in range(NUM_LIMBS)]
+
+
+def print_table(name, values):
+    print("static constexpr uint64_t %s[%d][%d] = {" % (name, len(values), NUM_LIMBS))
+    for value in values:
+        limbs = ["0x%016x" % limb for limb in montgomery_limbs(value)]
+        print("    {" + ",\n     ".join(limbs) + "},")
+    print("};")
+
+
+def main():
+    num_rounds = PARAM_F + PARAM_P
+    print("""// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+// Generated by poseidon_constants_generation.py. Do not edit.
+
+#ifndef __ZETH_CIRCUITS_POSEIDON_CONSTANTS_ALT_BN128_HPP__
+#define __ZETH_CIRCUITS_POSEIDON_CONSTANTS_ALT_BN128_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+// Constants of Poseidon128 (t = %d, F = %d, P = %d) over the scalar field of
+// alt_bn128, in Montgomery form (R = 2^256), as 64-bit limbs (least
+// significant first). `C` holds one constant per round, and `M` is the
+// t x t MDS matrix in row-major order.
+
+namespace libzeth
+{
+""" % (PARAM_T, PARAM_F, PARAM_P))
+    print_table(
+        "poseidon128_alt_bn128_C",
+        poseidon_constants("poseidon_constants", num_rounds))
+    print()
+    print_table(
+        "poseidon128_alt_bn128_M",
+        poseidon_matrix("poseidon_matrix_0000", PARAM_T))
+    print("""
+} // namespace libzeth
+
+#endif // __ZETH_CIRCUITS_POSEIDON_CONSTANTS_ALT_BN128_HPP__""")
+
+
+if __name__ == "__main__":
+    import sys
+    sys.exit(main())
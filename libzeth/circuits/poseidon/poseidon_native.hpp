@@ -0,0 +1,51 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_CIRCUITS_POSEIDON_NATIVE_HPP__
+#define __ZETH_CIRCUITS_POSEIDON_NATIVE_HPP__
+
+#include "libzeth/circuits/poseidon/poseidon_constants.hpp"
+
+#include <array>
+
+// Native (out-of-circuit) implementation of the Poseidon permutation, with
+// the same parameters and constants as Poseidon_gadget_T. The state is held
+// in a fixed-size array, and the constants are computed once, so hashing does
+// not allocate.
+
+namespace libzeth
+{
+
+template<
+    unsigned param_t,
+    unsigned param_c,
+    unsigned param_F,
+    unsigned param_P,
+    typename FieldT>
+class Poseidon_native_T
+{
+public:
+    using state_t = std::array<FieldT, param_t>;
+
+    // Apply all rounds of the permutation to `state`. Note that, as in the
+    // gadget, the last round only computes the first element of the output.
+    static void permute(state_t &state);
+
+    // Returns the hash of two elements (absorbed into a zero state)
+    static FieldT get_hash(const FieldT &x, const FieldT &y);
+
+private:
+    static const unsigned partial_begin = param_F / 2;
+    static const unsigned partial_end = partial_begin + param_P;
+    static const unsigned total_rounds = param_F + param_P;
+};
+
+template<typename FieldT>
+using Poseidon128_native = Poseidon_native_T<6, 1, 8, 57, FieldT>;
+
+} // namespace libzeth
+
+#include "libzeth/circuits/poseidon/poseidon_native.tcc"
+
+#endif // __ZETH_CIRCUITS_POSEIDON_NATIVE_HPP__
@@ -0,0 +1,76 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_CIRCUITS_POSEIDON_NATIVE_TCC__
+#define __ZETH_CIRCUITS_POSEIDON_NATIVE_TCC__
+
+namespace libzeth
+{
+
+template<
+    unsigned param_t,
+    unsigned param_c,
+    unsigned param_F,
+    unsigned param_P,
+    typename FieldT>
+void Poseidon_native_T<param_t, param_c, param_F, param_P, FieldT>::permute(
+    state_t &state)
+{
+    // Flat tables: one constant per round, and the row-major MDS matrix.
+    const PoseidonConstants<FieldT> &constants =
+        poseidon_params<param_t, param_F, param_P, FieldT>();
+    const FieldT *const C = constants.C.data();
+    const FieldT *const M = constants.M.data();
+
+    for (unsigned round = 0; round < total_rounds; ++round) {
+        const FieldT &C_i = C[round];
+        const bool is_partial = round >= partial_begin && round < partial_end;
+        const unsigned num_sboxes = is_partial ? param_c : param_t;
+
+        // Add the round constant, and apply the S-box (x^5) to the first
+        // `num_sboxes` elements.
+        for (unsigned j = 0; j < param_t; ++j) {
+            state[j] += C_i;
+            if (j < num_sboxes) {
+                const FieldT x2 = state[j] * state[j];
+                state[j] = x2 * x2 * state[j];
+            }
+        }
+
+        // Mix the state. The last round only needs the first output.
+        const unsigned num_outputs = (round == total_rounds - 1) ? 1 : param_t;
+        state_t mixed;
+        for (unsigned i = 0; i < num_outputs; ++i) {
+            FieldT sum = FieldT::zero();
+            for (unsigned j = 0; j < param_t; ++j) {
+                sum += M[i * param_t + j] * state[j];
+            }
+            mixed[i] = sum;
+        }
+        for (unsigned i = 0; i < num_outputs; ++i) {
+            state[i] = mixed[i];
+        }
+    }
+}
+
+template<
+    unsigned param_t,
+    unsigned param_c,
+    unsigned param_F,
+    unsigned param_P,
+    typename FieldT>
+FieldT Poseidon_native_T<param_t, param_c, param_F, param_P, FieldT>::get_hash(
+    const FieldT &x, const FieldT &y)
+{
+    state_t state;
+    state.fill(FieldT::zero());
+    state[0] = x;
+    state[1] = y;
+    permute(state);
+    return state[0];
+}
+
+} // namespace libzeth
+
+#endif // __ZETH_CIRCUITS_POSEIDON_NATIVE_TCC__
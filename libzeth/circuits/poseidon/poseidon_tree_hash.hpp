@@ -0,0 +1,54 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_CIRCUITS_POSEIDON_TREE_HASH_HPP__
+#define __ZETH_CIRCUITS_POSEIDON_TREE_HASH_HPP__
+
+#include "libzeth/circuits/circuit_utils.hpp"
+#include "libzeth/circuits/poseidon/poseidon.hpp"
+
+#include <libsnark/gadgetlib1/gadget.hpp>
+
+// This gadget implements the interface of the HashTreeT template
+//
+// Poseidon_tree_hash_gadget enforces the computation of the Poseidon sponge
+// (Poseidon128: t = 6, 8 full rounds, 57 partial rounds, x^5 S-box) absorbing
+// the 2 inputs into a zero state and squeezing a single field element. It can
+// be used in place of MiMC_mp_gadget in the Merkle tree gadgets (see
+// circuit_types.hpp).
+
+namespace libzeth
+{
+
+template<typename FieldT>
+class Poseidon_tree_hash_gadget : public libsnark::gadget<FieldT>
+{
+private:
+    using permutation_gadget_t = Poseidon128<2, 1, FieldT>;
+
+    // Permutation gadget (its single output is constrained to a variable)
+    permutation_gadget_t permutation_gadget;
+
+public:
+    Poseidon_tree_hash_gadget(
+        libsnark::protoboard<FieldT> &pb,
+        const libsnark::pb_variable<FieldT> x,
+        const libsnark::pb_variable<FieldT> y,
+        const std::string &annotation_prefix = "Poseidon_tree_hash_gadget");
+
+    void generate_r1cs_constraints();
+    void generate_r1cs_witness() const;
+
+    // Returns the hash computed
+    const libsnark::pb_variable<FieldT> &result() const;
+
+    // Returns the hash (field element)
+    static FieldT get_hash(const FieldT x, FieldT y);
+};
+
+} // namespace libzeth
+
+#include "libzeth/circuits/poseidon/poseidon_tree_hash.tcc"
+
+#endif // __ZETH_CIRCUITS_POSEIDON_TREE_HASH_HPP__
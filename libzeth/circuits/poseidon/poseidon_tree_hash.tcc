@@ -0,0 +1,50 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_CIRCUITS_POSEIDON_TREE_HASH_TCC__
+#define __ZETH_CIRCUITS_POSEIDON_TREE_HASH_TCC__
+
+namespace libzeth
+{
+
+template<typename FieldT>
+Poseidon_tree_hash_gadget<FieldT>::Poseidon_tree_hash_gadget(
+    libsnark::protoboard<FieldT> &pb,
+    const libsnark::pb_variable<FieldT> x,
+    const libsnark::pb_variable<FieldT> y,
+    const std::string &annotation_prefix)
+    : libsnark::gadget<FieldT>(pb, annotation_prefix)
+    , permutation_gadget(
+          pb, x, y, FMT(this->annotation_prefix, " permutation_gadget"))
+{
+}
+
+template<typename FieldT>
+void Poseidon_tree_hash_gadget<FieldT>::generate_r1cs_constraints()
+{
+    permutation_gadget.generate_r1cs_constraints();
+}
+
+template<typename FieldT>
+void Poseidon_tree_hash_gadget<FieldT>::generate_r1cs_witness() const
+{
+    permutation_gadget.generate_r1cs_witness();
+}
+
+template<typename FieldT>
+const libsnark::pb_variable<FieldT> &Poseidon_tree_hash_gadget<
+    FieldT>::result() const
+{
+    return permutation_gadget.result();
+}
+
+template<typename FieldT>
+FieldT Poseidon_tree_hash_gadget<FieldT>::get_hash(const FieldT x, FieldT y)
+{
+    return permutation_gadget_t::get_hash(x, y);
+}
+
+} // namespace libzeth
+
+#endif // __ZETH_CIRCUITS_POSEIDON_TREE_HASH_TCC__
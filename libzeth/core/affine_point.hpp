@@ -0,0 +1,59 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_CORE_AFFINE_POINT_HPP__
+#define __ZETH_CORE_AFFINE_POINT_HPP__
+
+#include "libzeth/core/include_libff.hpp"
+
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace libzeth
+{
+
+/// Point of an elliptic curve group of libff (such as G1 or G2) in affine
+/// coordinates. It holds two coordinates, where libff's representation holds
+/// three (X, Y, Z), and is intended for storing large numbers of points. The
+/// point at infinity is encoded as (0, 0), which is not on the curve for the
+/// curves supported (y^2 = x^3 + a*x + b, with b != 0).
+template<typename GroupT> class affine_point
+{
+public:
+    using coordinate_t =
+        typename std::decay<decltype(std::declval<GroupT>().X)>::type;
+
+    coordinate_t x;
+    coordinate_t y;
+
+    /// The point at infinity
+    affine_point();
+
+    affine_point(const coordinate_t &x, const coordinate_t &y);
+
+    /// Convert a point (with a field inversion, unless it is already
+    /// normalized).
+    explicit affine_point(const GroupT &g);
+
+    bool is_zero() const;
+
+    /// The point in libff's representation (normalized, with Z = 1, so that
+    /// it can be used in mixed additions).
+    GroupT to_group() const;
+
+    bool operator==(const affine_point &other) const;
+};
+
+/// Convert a vector of points to affine coordinates (in parallel, when built
+/// with MULTICORE).
+template<typename GroupT>
+std::vector<affine_point<GroupT>> affine_points_from_group(
+    const std::vector<GroupT> &points);
+
+} // namespace libzeth
+
+#include "libzeth/core/affine_point.tcc"
+
+#endif // __ZETH_CORE_AFFINE_POINT_HPP__
@@ -0,0 +1,79 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_CORE_AFFINE_POINT_TCC__
+#define __ZETH_CORE_AFFINE_POINT_TCC__
+
+#include "libzeth/core/affine_point.hpp"
+
+namespace libzeth
+{
+
+template<typename GroupT>
+affine_point<GroupT>::affine_point()
+    : x(coordinate_t::zero()), y(coordinate_t::zero())
+{
+}
+
+template<typename GroupT>
+affine_point<GroupT>::affine_point(const coordinate_t &x, const coordinate_t &y)
+    : x(x), y(y)
+{
+}
+
+template<typename GroupT>
+affine_point<GroupT>::affine_point(const GroupT &g)
+    : x(coordinate_t::zero()), y(coordinate_t::zero())
+{
+    if (g.is_zero()) {
+        return;
+    }
+    if (g.is_special()) {
+        x = g.X;
+        y = g.Y;
+        return;
+    }
+
+    GroupT normalized = g;
+    normalized.to_affine_coordinates();
+    x = normalized.X;
+    y = normalized.Y;
+}
+
+template<typename GroupT> bool affine_point<GroupT>::is_zero() const
+{
+    return x.is_zero() && y.is_zero();
+}
+
+template<typename GroupT> GroupT affine_point<GroupT>::to_group() const
+{
+    if (is_zero()) {
+        return GroupT::zero();
+    }
+    return GroupT(x, y, coordinate_t::one());
+}
+
+template<typename GroupT>
+bool affine_point<GroupT>::operator==(const affine_point &other) const
+{
+    return x == other.x && y == other.y;
+}
+
+template<typename GroupT>
+std::vector<affine_point<GroupT>> affine_points_from_group(
+    const std::vector<GroupT> &points)
+{
+    std::vector<affine_point<GroupT>> affine_points(points.size());
+#ifdef MULTICORE
+#pragma omp parallel for
+#endif
+    for (size_t i = 0; i < points.size(); ++i) {
+        affine_points[i] = affine_point<GroupT>(points[i]);
+    }
+    return affine_points;
+}
+
+} // namespace libzeth
+
+#endif // __ZETH_CORE_AFFINE_POINT_TCC__
@@ -0,0 +1,87 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_CORE_APPEND_MERKLE_TREE_FIELD_HPP__
+#define __ZETH_CORE_APPEND_MERKLE_TREE_FIELD_HPP__
+
+#include "libzeth/core/include_libff.hpp"
+
+#include <vector>
+
+namespace libzeth
+{
+
+/// Append-only Merkle tree whose nodes are field elements, matching the
+/// commitment tree maintained by the mixer contract (leaves are only ever
+/// added at the next free address).
+///
+/// Unlike `merkle_tree_field`, which supports arbitrary (sparse) updates
+/// using maps, the populated nodes of each layer are stored contiguously:
+/// `layers[l][i]` is the i-th node of layer `l` (layer 0 is the root, layer
+/// `depth` holds the leaves), and only the first ceil(num_leaves / 2^(depth -
+/// l)) nodes of layer `l` are stored. Nodes to the right of these have the
+/// default value for their layer.
+template<typename FieldT, typename HashTreeT> class append_merkle_tree_field
+{
+public:
+    explicit append_merkle_tree_field(size_t depth);
+
+    /// Build a tree from an initial set of leaves. The nodes of each layer
+    /// are computed in parallel (when built with MULTICORE).
+    append_merkle_tree_field(size_t depth, const std::vector<FieldT> &leaves);
+
+    size_t depth() const;
+    size_t num_leaves() const;
+
+    /// Maximum number of leaves (2^depth)
+    size_t capacity() const;
+
+    /// Append a single leaf, and update its Merkle path.
+    void append(const FieldT &leaf);
+
+    /// Append several leaves. Each parent node affected by the new leaves is
+    /// recomputed exactly once. Throws `std::invalid_argument` if the tree
+    /// does not have room for all leaves (in which case it is unchanged).
+    void append_batch(const std::vector<FieldT> &leaves);
+
+    /// Value of the leaf at `address` (zero for addresses which have not
+    /// been appended yet).
+    FieldT get_value(size_t address) const;
+
+    FieldT get_root() const;
+
+    /// Merkle authentication path for the leaf at `address`, from the
+    /// sibling of the leaf up to the child of the root (same order as
+    /// `merkle_tree_field::get_path`).
+    std::vector<FieldT> get_path(size_t address) const;
+
+    /// The populated nodes of `layer` (0 for the root, `depth` for the
+    /// leaves).
+    const std::vector<FieldT> &get_layer(size_t layer) const;
+
+private:
+    /// Value of node `idx` of `layer`, using the default value for nodes
+    /// which are not populated.
+    const FieldT &get_node(size_t layer, size_t idx) const;
+
+    /// Recompute all nodes of the layers above the leaves, starting at the
+    /// parent of leaf `first_leaf`. Large ranges of nodes are split between
+    /// threads (when built with MULTICORE), so `HashTreeT::get_hash` must be
+    /// thread-safe.
+    void update_parents(size_t first_leaf);
+
+    const size_t tree_depth;
+
+    /// Default (empty subtree) value of each layer. `hash_defaults[depth]` is
+    /// the empty leaf (zero).
+    std::vector<FieldT> hash_defaults;
+
+    std::vector<std::vector<FieldT>> layers;
+};
+
+} // namespace libzeth
+
+#include "libzeth/core/append_merkle_tree_field.tcc"
+
+#endif // __ZETH_CORE_APPEND_MERKLE_TREE_FIELD_HPP__
@@ -0,0 +1,171 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_CORE_APPEND_MERKLE_TREE_FIELD_TCC__
+#define __ZETH_CORE_APPEND_MERKLE_TREE_FIELD_TCC__
+
+#include "libzeth/core/append_merkle_tree_field.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace libzeth
+{
+
+template<typename FieldT, typename HashTreeT>
+append_merkle_tree_field<FieldT, HashTreeT>::append_merkle_tree_field(
+    size_t depth)
+    : tree_depth(depth), hash_defaults(depth + 1), layers(depth + 1)
+{
+    if (depth >= sizeof(size_t) * 8) {
+        throw std::invalid_argument("invalid Merkle tree depth");
+    }
+
+    // hash_defaults[l] is the root of an empty subtree of height depth - l.
+    hash_defaults[depth] = FieldT::zero();
+    for (size_t layer = depth; layer > 0; --layer) {
+        hash_defaults[layer - 1] =
+            HashTreeT::get_hash(hash_defaults[layer], hash_defaults[layer]);
+    }
+}
+
+template<typename FieldT, typename HashTreeT>
+append_merkle_tree_field<FieldT, HashTreeT>::append_merkle_tree_field(
+    size_t depth, const std::vector<FieldT> &leaves)
+    : append_merkle_tree_field(depth)
+{
+    append_batch(leaves);
+}
+
+template<typename FieldT, typename HashTreeT>
+size_t append_merkle_tree_field<FieldT, HashTreeT>::depth() const
+{
+    return tree_depth;
+}
+
+template<typename FieldT, typename HashTreeT>
+size_t append_merkle_tree_field<FieldT, HashTreeT>::num_leaves() const
+{
+    return layers[tree_depth].size();
+}
+
+template<typename FieldT, typename HashTreeT>
+size_t append_merkle_tree_field<FieldT, HashTreeT>::capacity() const
+{
+    return (size_t)1 << tree_depth;
+}
+
+template<typename FieldT, typename HashTreeT>
+void append_merkle_tree_field<FieldT, HashTreeT>::append(const FieldT &leaf)
+{
+    if (num_leaves() >= capacity()) {
+        throw std::invalid_argument("Merkle tree is full");
+    }
+
+    const size_t first_leaf = num_leaves();
+    layers[tree_depth].push_back(leaf);
+    update_parents(first_leaf);
+}
+
+template<typename FieldT, typename HashTreeT>
+void append_merkle_tree_field<FieldT, HashTreeT>::append_batch(
+    const std::vector<FieldT> &leaves)
+{
+    if (leaves.empty()) {
+        return;
+    }
+    if (leaves.size() > capacity() - num_leaves()) {
+        throw std::invalid_argument("not enough room in Merkle tree");
+    }
+
+    const size_t first_leaf = num_leaves();
+    std::vector<FieldT> &leaf_layer = layers[tree_depth];
+    leaf_layer.insert(leaf_layer.end(), leaves.begin(), leaves.end());
+    update_parents(first_leaf);
+}
+
+template<typename FieldT, typename HashTreeT>
+FieldT append_merkle_tree_field<FieldT, HashTreeT>::get_value(
+    size_t address) const
+{
+    return get_node(tree_depth, address);
+}
+
+template<typename FieldT, typename HashTreeT>
+FieldT append_merkle_tree_field<FieldT, HashTreeT>::get_root() const
+{
+    return get_node(0, 0);
+}
+
+template<typename FieldT, typename HashTreeT>
+std::vector<FieldT> append_merkle_tree_field<FieldT, HashTreeT>::get_path(
+    size_t address) const
+{
+    if (address >= capacity()) {
+        throw std::invalid_argument("address out of range");
+    }
+
+    std::vector<FieldT> path;
+    path.reserve(tree_depth);
+    size_t idx = address;
+    for (size_t layer = tree_depth; layer > 0; --layer) {
+        path.push_back(get_node(layer, idx ^ 1));
+        idx >>= 1;
+    }
+
+    return path;
+}
+
+template<typename FieldT, typename HashTreeT>
+const std::vector<FieldT> &append_merkle_tree_field<FieldT, HashTreeT>::
+    get_layer(size_t layer) const
+{
+    return layers[layer];
+}
+
+template<typename FieldT, typename HashTreeT>
+const FieldT &append_merkle_tree_field<FieldT, HashTreeT>::get_node(
+    size_t layer, size_t idx) const
+{
+    const std::vector<FieldT> &nodes = layers[layer];
+    return (idx < nodes.size()) ? nodes[idx] : hash_defaults[layer];
+}
+
+template<typename FieldT, typename HashTreeT>
+void append_merkle_tree_field<FieldT, HashTreeT>::update_parents(
+    size_t first_leaf)
+{
+    // At each layer, the nodes in [begin, end) of the child layer have
+    // changed (or been added). Their parents are in [begin / 2,
+    // ceil(end / 2)), and are recomputed once each, left to right.
+    size_t begin = first_leaf;
+    size_t end = layers[tree_depth].size();
+    for (size_t layer = tree_depth; layer > 0; --layer) {
+        const std::vector<FieldT> &children = layers[layer];
+        std::vector<FieldT> &parents = layers[layer - 1];
+
+        const size_t parent_begin = begin / 2;
+        const size_t parent_end = (end + 1) / 2;
+        parents.resize(parent_end);
+
+        // Nodes of a layer are independent. Small ranges (e.g. a single
+        // append) are not worth the cost of starting threads.
+#ifdef MULTICORE
+#pragma omp parallel for if (parent_end - parent_begin >= 64)
+#endif
+        for (size_t idx = parent_begin; idx < parent_end; ++idx) {
+            const size_t left = 2 * idx;
+            parents[idx] = HashTreeT::get_hash(
+                children[left],
+                (left + 1 < end) ? children[left + 1] : hash_defaults[layer]);
+        }
+
+        begin = parent_begin;
+        end = parent_end;
+    }
+}
+
+} // namespace libzeth
+
+#endif // __ZETH_CORE_APPEND_MERKLE_TREE_FIELD_TCC__
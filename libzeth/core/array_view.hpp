@@ -0,0 +1,48 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_CORE_ARRAY_VIEW_HPP__
+#define __ZETH_CORE_ARRAY_VIEW_HPP__
+
+#include <stddef.h>
+#include <vector>
+
+namespace libzeth
+{
+
+/// Read-only view of a contiguous array of elements, owned elsewhere (for
+/// example a std::vector, or a memory mapping). The view must not outlive the
+/// array.
+template<typename T> class array_view
+{
+public:
+    array_view() : elements(nullptr), num_elements(0) {}
+
+    array_view(const T *elements, size_t num_elements)
+        : elements(elements), num_elements(num_elements)
+    {
+    }
+
+    array_view(const std::vector<T> &v)
+        : elements(v.data()), num_elements(v.size())
+    {
+    }
+
+    const T *data() const { return elements; }
+    size_t size() const { return num_elements; }
+    bool empty() const { return num_elements == 0; }
+
+    const T *begin() const { return elements; }
+    const T *end() const { return elements + num_elements; }
+
+    const T &operator[](size_t i) const { return elements[i]; }
+
+private:
+    const T *elements;
+    size_t num_elements;
+};
+
+} // namespace libzeth
+
+#endif // __ZETH_CORE_ARRAY_VIEW_HPP__
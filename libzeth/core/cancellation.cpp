@@ -0,0 +1,28 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#include "libzeth/core/cancellation.hpp"
+
+namespace libzeth
+{
+
+operation_cancelled::operation_cancelled()
+    : std::runtime_error("operation cancelled")
+{
+}
+
+cancellation_token::cancellation_token() : cancelled(false) {}
+
+void cancellation_token::cancel() { cancelled = true; }
+
+bool cancellation_token::is_cancelled() const { return cancelled; }
+
+void cancellation_token::check() const
+{
+    if (cancelled) {
+        throw operation_cancelled();
+    }
+}
+
+} // namespace libzeth
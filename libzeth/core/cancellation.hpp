@@ -0,0 +1,46 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_CORE_CANCELLATION_HPP__
+#define __ZETH_CORE_CANCELLATION_HPP__
+
+#include <atomic>
+#include <stdexcept>
+
+namespace libzeth
+{
+
+/// Thrown by an operation which stopped early because it was cancelled.
+class operation_cancelled : public std::runtime_error
+{
+public:
+    operation_cancelled();
+};
+
+/// Flag through which the owner of a long running operation (such as proof
+/// generation) can ask for it to stop. The operation checks the token between
+/// its major phases, so cancellation takes effect at the next check. May be
+/// used from several threads concurrently.
+class cancellation_token
+{
+public:
+    cancellation_token();
+
+    cancellation_token(const cancellation_token &) = delete;
+    cancellation_token &operator=(const cancellation_token &) = delete;
+
+    void cancel();
+
+    bool is_cancelled() const;
+
+    /// Throw `operation_cancelled` if the token has been cancelled.
+    void check() const;
+
+private:
+    std::atomic<bool> cancelled;
+};
+
+} // namespace libzeth
+
+#endif // __ZETH_CORE_CANCELLATION_HPP__
@@ -5,6 +5,7 @@
 #ifndef __ZETH_CORE_MERKLE_TREE_FIELD_TCC__
 #define __ZETH_CORE_MERKLE_TREE_FIELD_TCC__
 
+#include "libzeth/core/append_merkle_tree_field.hpp"
 #include "libzeth/core/merkle_tree_field.hpp"
 
 #include <algorithm>
@@ -42,30 +43,27 @@ merkle_tree_field<FieldT, HashTreeT>::merkle_tree_field(
     : merkle_tree_field<FieldT, HashTreeT>(depth)
 {
     assert(libff::log2(contents_as_vector.size()) <= depth);
-    for (size_t address = 0; address < contents_as_vector.size(); ++address) {
-        // `1ul << depth` returns the total number of leaves in the merkle tree
-        // of depth `depth`
-        const size_t idx = address + (1ul << depth) - 1;
-        values[idx] = contents_as_vector[address];
-        hashes[idx] = contents_as_vector[address];
-    }
 
-    size_t idx_begin = (1ul << depth) - 1;
-    size_t idx_end = contents_as_vector.size() + ((1ul << depth) - 1);
+    // Compute all layers in contiguous buffers (in parallel when built with
+    // MULTICORE), and then populate the maps.
+    const append_merkle_tree_field<FieldT, HashTreeT> tree(
+        depth, contents_as_vector);
 
-    for (int layer = depth; layer > 0; --layer) {
-        for (size_t idx = idx_begin; idx < idx_end; idx += 2) {
-            FieldT l = hashes[idx]; // this is sound, because idx_begin is
-                                    // always a left child
-            FieldT r =
-                (idx + 1 < idx_end ? hashes[idx + 1] : hash_defaults[layer]);
+    for (size_t address = 0; address < contents_as_vector.size(); ++address) {
+        values.emplace_hint(
+            values.end(), address, contents_as_vector[address]);
+    }
 
-            FieldT h = HashTreeT::get_hash(l, r);
-            hashes[(idx - 1) / 2] = h;
+    // Node indices increase with the layer, so all insertions are at the end
+    // of the map.
+    for (size_t layer = 0; layer <= depth; ++layer) {
+        // `1ul << layer` is the number of nodes in layer `layer`, and the
+        // index of its first node is `(1ul << layer) - 1`
+        const size_t layer_offset = (1ul << layer) - 1;
+        const std::vector<FieldT> &nodes = tree.get_layer(layer);
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            hashes.emplace_hint(hashes.end(), layer_offset + i, nodes[i]);
         }
-
-        idx_begin = (idx_begin - 1) / 2;
-        idx_end = (idx_end - 1) / 2;
     }
 }
 
@@ -0,0 +1,48 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#include "libzeth/core/multi_exp.hpp"
+
+#include <algorithm>
+
+#ifdef MULTICORE
+#include <omp.h>
+#endif
+
+namespace libzeth
+{
+
+// Minimum number of terms handled by each thread.
+static const size_t MULTI_EXP_MIN_CHUNK_SIZE = 1024;
+
+// Bounds on the window size, keeping the number of buckets (and the memory
+// for bucket offsets) reasonable.
+static const size_t MULTI_EXP_MIN_WINDOW_BITS = 2;
+static const size_t MULTI_EXP_MAX_WINDOW_BITS = 20;
+
+size_t multi_exp_window_bits(size_t num_elements)
+{
+    // Approximately ln(n) + 2. Affine bucket accumulation makes additions
+    // cheap, compared to the doublings and the bucket running sums, which
+    // favours slightly larger windows than for projective accumulation.
+    const size_t bits = (libff::log2(num_elements) * 69) / 100 + 2;
+    return std::max(
+        MULTI_EXP_MIN_WINDOW_BITS, std::min(bits, MULTI_EXP_MAX_WINDOW_BITS));
+}
+
+size_t multi_exp_num_threads(size_t num_elements, size_t num_threads)
+{
+#ifdef MULTICORE
+    if (num_threads == 0) {
+        num_threads = omp_in_parallel() ? 1 : (size_t)omp_get_max_threads();
+    }
+#else
+    num_threads = 1;
+#endif
+    const size_t max_chunks = (num_elements + MULTI_EXP_MIN_CHUNK_SIZE - 1) /
+                              MULTI_EXP_MIN_CHUNK_SIZE;
+    return std::max<size_t>(1, std::min(num_threads, max_chunks));
+}
+
+} // namespace libzeth
@@ -5,11 +5,17 @@
 #ifndef __ZETH_CORE_MULTI_EXP_HPP__
 #define __ZETH_CORE_MULTI_EXP_HPP__
 
+#include "libzeth/core/affine_point.hpp"
 #include "libzeth/core/include_libff.hpp"
 
+#include <vector>
+
 namespace libzeth
 {
 
+/// Compute sum_i fs[i] * gs[i], using `multi_exp_pippenger` with the
+/// default parameters (all available cores, window chosen from the number of
+/// elements).
 template<typename FieldT, typename GroupT>
 GroupT multi_exp(
     typename std::vector<GroupT>::const_iterator gs_start,
@@ -21,6 +27,53 @@ template<typename ppT, typename GroupT>
 GroupT multi_exp(
     const std::vector<GroupT> &gs, const libff::Fr_vector<ppT> &fs);
 
+/// Multi-exponentiation using the bucket method of Pippenger. The inputs are
+/// split into one chunk per thread, and the points of each chunk (converted
+/// to affine coordinates) are sorted into buckets, window by window. The
+/// points of each bucket are summed in affine coordinates, pairwise, with one
+/// (batched) field inversion per round for the whole window, which is much
+/// cheaper than accumulating in projective coordinates.
+///
+/// `GroupT` must be an elliptic curve group of libff (such as G1 or G2),
+/// exposing its X, Y and Z coordinates. Input points need not be normalized,
+/// but normalized points avoid a conversion.
+///
+/// `num_threads` is the number of threads to use (0 to use all available
+/// cores, or a single thread when called from a parallel region).
+/// `window_bits` is the size (in bits) of the bucket window (0 to derive it
+/// from the number of elements of each chunk, see `multi_exp_window_bits`).
+template<typename FieldT, typename GroupT>
+GroupT multi_exp_pippenger(
+    typename std::vector<GroupT>::const_iterator gs_start,
+    typename std::vector<GroupT>::const_iterator gs_end,
+    typename std::vector<FieldT>::const_iterator fs_start,
+    typename std::vector<FieldT>::const_iterator fs_end,
+    size_t num_threads,
+    size_t window_bits);
+
+/// Multi-exponentiation as `multi_exp_pippenger`, for an array of points
+/// stored in affine coordinates (as in `groth16_affine_proving_key`). The
+/// points are used in place, without any conversion, and may be in read-only
+/// shared memory.
+template<typename FieldT, typename GroupT>
+GroupT multi_exp_affine(
+    const affine_point<GroupT> *gs_start,
+    const affine_point<GroupT> *gs_end,
+    typename std::vector<FieldT>::const_iterator fs_start,
+    typename std::vector<FieldT>::const_iterator fs_end,
+    size_t num_threads,
+    size_t window_bits);
+
+/// Default window size (in bits) for a multi-exponentiation of
+/// `num_elements` terms.
+size_t multi_exp_window_bits(size_t num_elements);
+
+/// Number of threads used for a multi-exponentiation of `num_elements`
+/// terms, when `num_threads` threads are requested (0 for the default).
+/// Chunks are never smaller than a minimum size, so that the overhead of
+/// each thread remains negligible.
+size_t multi_exp_num_threads(size_t num_elements, size_t num_threads);
+
 } // namespace libzeth
 
 #include "libzeth/core/multi_exp.tcc"
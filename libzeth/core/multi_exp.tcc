@@ -7,9 +7,307 @@
 
 #include "libzeth/core/multi_exp.hpp"
 
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
 namespace libzeth
 {
 
+namespace
+{
+
+// Below this number of terms, the bucket method does not pay off and the
+// terms are computed one at a time.
+const size_t MULTI_EXP_MIN_PIPPENGER_SIZE = 8;
+
+// Return the `bits` bits of `b` starting at bit `offset`.
+template<mp_size_t n>
+size_t bigint_window(const libff::bigint<n> &b, size_t offset, size_t bits)
+{
+    const size_t limb = offset / GMP_NUMB_BITS;
+    const size_t shift = offset % GMP_NUMB_BITS;
+    if (limb >= (size_t)n) {
+        return 0;
+    }
+
+    mp_limb_t value = b.data[limb] >> shift;
+    if (shift + bits > GMP_NUMB_BITS && limb + 1 < (size_t)n) {
+        value |= b.data[limb + 1] << (GMP_NUMB_BITS - shift);
+    }
+    return (size_t)(value & ((((mp_limb_t)1) << bits) - 1));
+}
+
+// Reduce the points of each bucket b (the range [offsets[b], offsets[b+1])
+// of `points`) to at most one point, by adding pairs of points in affine
+// coordinates. All additions of a round share a single field inversion
+// (Montgomery's trick), so that each one costs a few multiplications.
+// `scratch_points` and `scratch_offsets` are used as temporary storage.
+template<typename GroupT>
+void multi_exp_reduce_buckets(
+    std::vector<affine_point<GroupT>> &points,
+    std::vector<size_t> &offsets,
+    std::vector<affine_point<GroupT>> &scratch_points,
+    std::vector<size_t> &scratch_offsets)
+{
+    using point_t = affine_point<GroupT>;
+    using coordinate_t = typename point_t::coordinate_t;
+
+    const size_t num_buckets = offsets.size() - 1;
+    std::vector<coordinate_t> inverses;
+    std::vector<bool> is_exceptional;
+
+    for (;;) {
+        // Denominators (x2 - x1) of all pairs of the round. Pairs with
+        // x1 == x2 (doubling, or adding a point to its inverse) are handled
+        // in projective coordinates.
+        inverses.clear();
+        is_exceptional.clear();
+        for (size_t b = 0; b < num_buckets; ++b) {
+            for (size_t i = offsets[b]; i + 1 < offsets[b + 1]; i += 2) {
+                const coordinate_t dx = points[i + 1].x - points[i].x;
+                is_exceptional.push_back(dx.is_zero());
+                inverses.push_back(dx.is_zero() ? coordinate_t::one() : dx);
+            }
+        }
+        if (inverses.empty()) {
+            return;
+        }
+        libff::batch_invert(inverses);
+
+        scratch_points.resize(points.size());
+        scratch_offsets.resize(offsets.size());
+        size_t out = 0;
+        size_t pair = 0;
+        for (size_t b = 0; b < num_buckets; ++b) {
+            scratch_offsets[b] = out;
+            size_t i = offsets[b];
+            for (; i + 1 < offsets[b + 1]; i += 2, ++pair) {
+                const point_t &p1 = points[i];
+                const point_t &p2 = points[i + 1];
+                if (is_exceptional[pair]) {
+                    GroupT sum = p1.to_group() + p2.to_group();
+                    if (!sum.is_zero()) {
+                        sum.to_affine_coordinates();
+                        scratch_points[out].x = sum.X;
+                        scratch_points[out].y = sum.Y;
+                        ++out;
+                    }
+                    continue;
+                }
+
+                const coordinate_t lambda = (p2.y - p1.y) * inverses[pair];
+                point_t &p3 = scratch_points[out++];
+                p3.x = lambda.squared() - p1.x - p2.x;
+                p3.y = lambda * (p1.x - p3.x) - p1.y;
+            }
+            if (i < offsets[b + 1]) {
+                scratch_points[out++] = points[i];
+            }
+        }
+        scratch_offsets[num_buckets] = out;
+        scratch_points.resize(out);
+
+        points.swap(scratch_points);
+        offsets.swap(scratch_offsets);
+    }
+}
+
+// Bucket method on the terms sum_i fs[i] * points[i] for i in [0, n), in a
+// single thread.
+template<typename FieldT, typename GroupT>
+GroupT multi_exp_affine_chunk(
+    const affine_point<GroupT> *points,
+    const FieldT *fs,
+    size_t n,
+    size_t window_bits)
+{
+    using point_t = affine_point<GroupT>;
+    using bigint_t = libff::bigint<FieldT::num_limbs>;
+
+    // Indices and scalars of the non-trivial terms.
+    std::vector<size_t> terms;
+    std::vector<bigint_t> scalars;
+    for (size_t i = 0; i < n; ++i) {
+        if (!points[i].is_zero() && !fs[i].is_zero()) {
+            terms.push_back(i);
+            scalars.push_back(fs[i].as_bigint());
+        }
+    }
+    if (terms.empty()) {
+        return GroupT::zero();
+    }
+
+    // Bucket b holds the points whose window digit is b + 1.
+    const size_t num_buckets = ((size_t)1 << window_bits) - 1;
+    const size_t num_windows =
+        (FieldT::num_bits + window_bits - 1) / window_bits;
+    std::vector<size_t> offsets(num_buckets + 1);
+    std::vector<size_t> cursors(num_buckets);
+    std::vector<point_t> bucket_points;
+    std::vector<point_t> scratch_points;
+    std::vector<size_t> scratch_offsets;
+
+    GroupT result = GroupT::zero();
+    for (size_t w = num_windows; w-- > 0;) {
+        for (size_t i = 0; i < window_bits; ++i) {
+            result = result.dbl();
+        }
+
+        // Sort the points into buckets, by digit.
+        const size_t window_offset = w * window_bits;
+        std::fill(offsets.begin(), offsets.end(), 0);
+        for (const bigint_t &s : scalars) {
+            const size_t digit = bigint_window(s, window_offset, window_bits);
+            if (digit != 0) {
+                ++offsets[digit];
+            }
+        }
+        for (size_t b = 0; b < num_buckets; ++b) {
+            offsets[b + 1] += offsets[b];
+            cursors[b] = offsets[b];
+        }
+        bucket_points.resize(offsets[num_buckets]);
+        for (size_t i = 0; i < scalars.size(); ++i) {
+            const size_t digit =
+                bigint_window(scalars[i], window_offset, window_bits);
+            if (digit != 0) {
+                bucket_points[cursors[digit - 1]++] = points[terms[i]];
+            }
+        }
+
+        multi_exp_reduce_buckets<GroupT>(
+            bucket_points, offsets, scratch_points, scratch_offsets);
+
+        // sum_b (b + 1) * bucket_b, as a sum of running sums.
+        GroupT running_sum = GroupT::zero();
+        GroupT window_sum = GroupT::zero();
+        for (size_t b = num_buckets; b-- > 0;) {
+            if (offsets[b + 1] > offsets[b]) {
+                running_sum =
+                    running_sum.mixed_add(bucket_points[offsets[b]].to_group());
+            }
+            if (!running_sum.is_zero()) {
+                window_sum = window_sum + running_sum;
+            }
+        }
+        result = result + window_sum;
+    }
+
+    return result;
+}
+
+// Split the terms [0, num_elements) into chunks, and sum the results of
+// `chunk_fn(begin, end, window_bits)` for each chunk, in parallel.
+template<typename GroupT, typename ChunkFnT>
+GroupT multi_exp_chunks(
+    size_t num_elements,
+    size_t num_threads,
+    size_t window_bits,
+    const ChunkFnT &chunk_fn)
+{
+    const size_t num_chunks = multi_exp_num_threads(num_elements, num_threads);
+    const size_t chunk_size = (num_elements + num_chunks - 1) / num_chunks;
+    std::vector<GroupT> partial_sums(num_chunks, GroupT::zero());
+
+#ifdef MULTICORE
+#pragma omp parallel for num_threads((int)num_chunks)
+#endif
+    for (size_t i = 0; i < num_chunks; ++i) {
+        const size_t begin = i * chunk_size;
+        const size_t end = std::min(begin + chunk_size, num_elements);
+        if (begin >= end) {
+            continue;
+        }
+
+        const size_t chunk_window_bits =
+            (window_bits != 0) ? window_bits
+                               : multi_exp_window_bits(end - begin);
+        partial_sums[i] = chunk_fn(begin, end, chunk_window_bits);
+    }
+
+    GroupT result = GroupT::zero();
+    for (const GroupT &partial_sum : partial_sums) {
+        result = result + partial_sum;
+    }
+    return result;
+}
+
+} // namespace
+
+template<typename FieldT, typename GroupT>
+GroupT multi_exp_pippenger(
+    typename std::vector<GroupT>::const_iterator gs_start,
+    typename std::vector<GroupT>::const_iterator gs_end,
+    typename std::vector<FieldT>::const_iterator fs_start,
+    typename std::vector<FieldT>::const_iterator fs_end,
+    size_t num_threads,
+    size_t window_bits)
+{
+    if (gs_end - gs_start != fs_end - fs_start) {
+        throw std::invalid_argument("multi_exp: mismatched input sizes");
+    }
+
+    const size_t num_elements = fs_end - fs_start;
+    if (num_elements < MULTI_EXP_MIN_PIPPENGER_SIZE) {
+        GroupT result = GroupT::zero();
+        for (size_t i = 0; i < num_elements; ++i) {
+            result = result + (*(fs_start + i)) * (*(gs_start + i));
+        }
+        return result;
+    }
+
+    // Each chunk is converted to affine coordinates.
+    return multi_exp_chunks<GroupT>(
+        num_elements,
+        num_threads,
+        window_bits,
+        [&](size_t begin, size_t end, size_t chunk_window_bits) {
+            std::vector<affine_point<GroupT>> points;
+            points.reserve(end - begin);
+            for (size_t i = begin; i < end; ++i) {
+                points.emplace_back(*(gs_start + i));
+            }
+            return multi_exp_affine_chunk<FieldT, GroupT>(
+                points.data(),
+                &*(fs_start + begin),
+                end - begin,
+                chunk_window_bits);
+        });
+}
+
+template<typename FieldT, typename GroupT>
+GroupT multi_exp_affine(
+    const affine_point<GroupT> *gs_start,
+    const affine_point<GroupT> *gs_end,
+    typename std::vector<FieldT>::const_iterator fs_start,
+    typename std::vector<FieldT>::const_iterator fs_end,
+    size_t num_threads,
+    size_t window_bits)
+{
+    if (gs_end - gs_start != fs_end - fs_start) {
+        throw std::invalid_argument("multi_exp: mismatched input sizes");
+    }
+
+    const size_t num_elements = fs_end - fs_start;
+    if (num_elements == 0) {
+        return GroupT::zero();
+    }
+
+    return multi_exp_chunks<GroupT>(
+        num_elements,
+        num_threads,
+        window_bits,
+        [&](size_t begin, size_t end, size_t chunk_window_bits) {
+            return multi_exp_affine_chunk<FieldT, GroupT>(
+                gs_start + begin,
+                &*(fs_start + begin),
+                end - begin,
+                chunk_window_bits);
+        });
+}
+
 template<typename FieldT, typename GroupT>
 GroupT multi_exp(
     typename std::vector<GroupT>::const_iterator gs_start,
@@ -17,9 +315,8 @@ GroupT multi_exp(
     typename std::vector<FieldT>::const_iterator fs_start,
     typename std::vector<FieldT>::const_iterator fs_end)
 {
-    const libff::multi_exp_method Method = libff::multi_exp_method_BDLO12;
-    return libff::multi_exp_with_mixed_addition<GroupT, FieldT, Method>(
-        gs_start, gs_end, fs_start, fs_end, 1);
+    return multi_exp_pippenger<FieldT, GroupT>(
+        gs_start, gs_end, fs_start, fs_end, 0, 0);
 }
 
 template<typename ppT, typename GroupT>
@@ -29,9 +326,8 @@ GroupT multi_exp(const std::vector<GroupT> &gs, const libff::Fr_vector<ppT> &fs)
     assert(gs.size() > 0);
 
     using Fr = libff::Fr<ppT>;
-    const libff::multi_exp_method Method = libff::multi_exp_method_BDLO12;
-    return libff::multi_exp_with_mixed_addition<GroupT, Fr, Method>(
-        gs.begin(), gs.begin() + fs.size(), fs.begin(), fs.end(), 1);
+    return multi_exp_pippenger<Fr, GroupT>(
+        gs.begin(), gs.begin() + fs.size(), fs.begin(), fs.end(), 0, 0);
 }
 
 } // namespace libzeth
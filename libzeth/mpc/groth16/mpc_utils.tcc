@@ -18,6 +18,81 @@
 namespace libzeth
 {
 
+namespace
+{
+
+// Number of terms (in A, B and C) above which a variable is considered dense,
+// and is evaluated using all threads.
+const size_t MPC_DENSE_VARIABLE_NUM_TERMS = 4096;
+
+template<typename ppT>
+size_t mpc_variable_num_terms(
+    const libsnark::qap_instance<libff::Fr<ppT>> &qap, size_t j)
+{
+    return qap.A_in_Lagrange_basis[j].size() +
+           qap.B_in_Lagrange_basis[j].size() +
+           qap.C_in_Lagrange_basis[j].size();
+}
+
+// Evaluate a polynomial, given by its factors in the Lagrange basis, from the
+// evaluations of the Lagrange polynomials (encoded in GroupT).
+template<typename ppT, typename GroupT>
+GroupT mpc_evaluate_lagrange_factors(
+    const std::map<size_t, libff::Fr<ppT>> &lagrange_factors,
+    const std::vector<GroupT> &lagrange_evaluations,
+    size_t num_threads)
+{
+    std::vector<GroupT> gs;
+    libff::Fr_vector<ppT> fs;
+    gs.reserve(lagrange_factors.size());
+    fs.reserve(lagrange_factors.size());
+    for (const auto &entry : lagrange_factors) {
+        gs.push_back(lagrange_evaluations[entry.first]);
+        fs.push_back(entry.second);
+    }
+
+    return multi_exp_pippenger<libff::Fr<ppT>, GroupT>(
+        gs.begin(), gs.end(), fs.begin(), fs.end(), num_threads, 0);
+}
+
+// Compute [A_j(x)]_1, [B_j(x)]_1, [B_j(x)]_2, [C_j(x)]_1 and
+// [ABC_j(x)]_1 = [beta . A_j(x) + alpha . B_j(x) + C_j(x)]_1 for variable j.
+template<typename ppT>
+void mpc_evaluate_variable(
+    const srs_lagrange_evaluations<ppT> &lagrange,
+    const libsnark::qap_instance<libff::Fr<ppT>> &qap,
+    size_t j,
+    size_t num_threads,
+    libff::G1<ppT> &A_j_at_x,
+    libff::G1<ppT> &B_j_at_x_g1,
+    libff::G2<ppT> &B_j_at_x_g2,
+    libff::G1<ppT> &C_j_at_x,
+    libff::G1<ppT> &ABC_j_at_x)
+{
+    const std::map<size_t, libff::Fr<ppT>> &A_j_lagrange =
+        qap.A_in_Lagrange_basis[j];
+    const std::map<size_t, libff::Fr<ppT>> &B_j_lagrange =
+        qap.B_in_Lagrange_basis[j];
+    const std::map<size_t, libff::Fr<ppT>> &C_j_lagrange =
+        qap.C_in_Lagrange_basis[j];
+
+    A_j_at_x = mpc_evaluate_lagrange_factors<ppT>(
+        A_j_lagrange, lagrange.lagrange_g1, num_threads);
+    B_j_at_x_g1 = mpc_evaluate_lagrange_factors<ppT>(
+        B_j_lagrange, lagrange.lagrange_g1, num_threads);
+    B_j_at_x_g2 = mpc_evaluate_lagrange_factors<ppT>(
+        B_j_lagrange, lagrange.lagrange_g2, num_threads);
+    C_j_at_x = mpc_evaluate_lagrange_factors<ppT>(
+        C_j_lagrange, lagrange.lagrange_g1, num_threads);
+    ABC_j_at_x = mpc_evaluate_lagrange_factors<ppT>(
+                     A_j_lagrange, lagrange.beta_lagrange_g1, num_threads) +
+                 mpc_evaluate_lagrange_factors<ppT>(
+                     B_j_lagrange, lagrange.alpha_lagrange_g1, num_threads) +
+                 C_j_at_x;
+}
+
+} // namespace
+
 template<typename ppT>
 srs_mpc_layer_L1<ppT>::srs_mpc_layer_L1(
     libff::G1_vector<ppT> &&T_tau_powers_g1,
@@ -135,9 +210,7 @@ srs_mpc_layer_L1<ppT> mpc_compute_linearcombination(
     const srs_lagrange_evaluations<ppT> &lagrange,
     const libsnark::qap_instance<libff::Fr<ppT>> &qap)
 {
-    using Fr = libff::Fr<ppT>;
     using G1 = libff::G1<ppT>;
-    using G2 = libff::G2<ppT>;
     libff::enter_block("Call to mpc_compute_linearcombination");
 
     // n = number of constraints in r1cs, or equivalently, n = deg(t(x))
@@ -185,67 +258,56 @@ srs_mpc_layer_L1<ppT> mpc_compute_linearcombination(
     libff::G2_vector<ppT> Bs_g2(num_variables + 1);
     libff::G1_vector<ppT> Cs_g1(num_variables + 1);
     libff::G1_vector<ppT> ABCs_g1(num_variables + 1);
-#ifdef MULTICORE
-#pragma omp parallel for
-#endif
-    for (size_t j = 0; j < num_variables + 1; ++j) {
-        G1 ABC_j_at_x = G1::zero();
-
-        {
-            G1 A_j_at_x = G1::zero();
-            const std::map<size_t, Fr> &A_j_lagrange =
-                qap.A_in_Lagrange_basis[j];
-            for (const auto &entry : A_j_lagrange) {
-                A_j_at_x = A_j_at_x +
-                           (entry.second * lagrange.lagrange_g1[entry.first]);
-                ABC_j_at_x =
-                    ABC_j_at_x +
-                    (entry.second * lagrange.beta_lagrange_g1[entry.first]);
-            }
-
-            As_g1[j] = A_j_at_x;
-        }
 
-        {
-            G1 B_j_at_x_g1 = G1::zero();
-            G2 B_j_at_x_g2 = G2::zero();
-
-            const std::map<size_t, Fr> &B_j_lagrange =
-                qap.B_in_Lagrange_basis[j];
-            for (const auto &entry : B_j_lagrange) {
-                B_j_at_x_g1 = B_j_at_x_g1 + (entry.second *
-                                             lagrange.lagrange_g1[entry.first]);
-                B_j_at_x_g2 = B_j_at_x_g2 + (entry.second *
-                                             lagrange.lagrange_g2[entry.first]);
-                ABC_j_at_x =
-                    ABC_j_at_x +
-                    (entry.second * lagrange.alpha_lagrange_g1[entry.first]);
-            }
-
-            Bs_g1[j] = B_j_at_x_g1;
-            Bs_g2[j] = B_j_at_x_g2;
+    // Most variables appear in few constraints. These are evaluated in
+    // parallel, one variable per thread. Dense variables (such as the
+    // constant 1, which can appear in every constraint) are evaluated
+    // afterwards, one at a time, each using all threads for its
+    // multi-exponentiations.
+    std::vector<size_t> dense_variables;
+    for (size_t j = 0; j < num_variables + 1; ++j) {
+        if (mpc_variable_num_terms(qap, j) >= MPC_DENSE_VARIABLE_NUM_TERMS) {
+            dense_variables.push_back(j);
         }
+    }
 
-        {
-            G1 C_j_at_x = G1::zero();
-            const std::map<size_t, Fr> &C_j_lagrange =
-                qap.C_in_Lagrange_basis[j];
-            for (const auto &entry : C_j_lagrange) {
-                C_j_at_x =
-                    C_j_at_x + entry.second * lagrange.lagrange_g1[entry.first];
-            }
-
-            Cs_g1[j] = C_j_at_x;
-            ABC_j_at_x = ABC_j_at_x + C_j_at_x;
+#ifdef MULTICORE
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+    for (size_t j = 0; j < num_variables + 1; ++j) {
+        if (mpc_variable_num_terms(qap, j) >= MPC_DENSE_VARIABLE_NUM_TERMS) {
+            continue;
         }
+        mpc_evaluate_variable(
+            lagrange,
+            qap,
+            j,
+            1,
+            As_g1[j],
+            Bs_g1[j],
+            Bs_g2[j],
+            Cs_g1[j],
+            ABCs_g1[j]);
+    }
 
-        ABCs_g1[j] = ABC_j_at_x;
+    for (const size_t j : dense_variables) {
+        mpc_evaluate_variable(
+            lagrange,
+            qap,
+            j,
+            0,
+            As_g1[j],
+            Bs_g1[j],
+            Bs_g2[j],
+            Cs_g1[j],
+            ABCs_g1[j]);
     }
     libff::leave_block("computing A_i, B_i, C_i, ABC_i at x");
 
-    // TODO: Consider dropping those entries we know will not be used
-    // by this circuit and using sparse vectors where it makes sense
-    // (as is done for B_i's in r1cs_gg_ppzksnark_proving_key).
+    // The entries for variables which do not appear in A (resp. B) are
+    // zero. The layer remains dense, since phase 2 and its transcripts
+    // index it by variable. The zero entries are dropped from B_query in
+    // mpc_create_key_pair, and from all queries of the affine proving key.
     libff::leave_block("Call to mpc_compute_linearcombination");
 
     return srs_mpc_layer_L1<ppT>(
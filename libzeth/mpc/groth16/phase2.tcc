@@ -702,13 +702,22 @@ libsnark::r1cs_gg_ppzksnark_keypair<ppT> mpc_create_key_pair(
         throw std::invalid_argument("insufficient POT entries");
     }
 
-    // { ( [B_i]_2, [B_i]_1 ) } i = 0 .. num_variables
-    std::vector<libsnark::knowledge_commitment<G2, G1>> B_i(num_variables + 1);
+    // { ( [B_i]_2, [B_i]_1 ) } i = 0 .. num_variables, as a sparse vector.
+    // As in the libsnark generator, entries are omitted for variables which
+    // do not appear in B (for which both points are zero), so that they are
+    // neither stored nor processed by the prover.
+    libsnark::knowledge_commitment_vector<G2, G1> B_query;
+    B_query.domain_size_ = num_variables + 1;
     for (size_t i = 0; i < num_variables + 1; ++i) {
-        B_i[i] = libsnark::knowledge_commitment<G2, G1>(
-            layer1.B_g2[i], layer1.B_g1[i]);
+        if (layer1.B_g2[i].is_zero() && layer1.B_g1[i].is_zero()) {
+            continue;
+        }
+        B_query.indices.push_back(i);
+        B_query.values.push_back(libsnark::knowledge_commitment<G2, G1>(
+            layer1.B_g2[i], layer1.B_g1[i]));
     }
-    assert(B_i.size() == num_variables + 1);
+    libff::G2_vector<ppT>().swap(layer1.B_g2);
+    libff::G1_vector<ppT>().swap(layer1.B_g1);
 
     // [ ABC_0 ]_1,  { [ABC_i]_1 }, i = 1 .. num_inputs
     G1 ABC_0 = layer1.ABC_g1[0];
@@ -730,7 +739,7 @@ libsnark::r1cs_gg_ppzksnark_keypair<ppT> mpc_create_key_pair(
         G1(layer2.delta_g1),
         G2(layer2.delta_g2),
         std::move(layer1.A_g1),
-        libsnark::knowledge_commitment_vector<G2, G1>(std::move(B_i)),
+        std::move(B_query),
         std::move(layer2.H_g1),
         std::move(layer2.L_g1),
         std::move(cs));
@@ -0,0 +1,68 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#include "libzeth/serialization/mapped_file.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace libzeth
+{
+
+mapped_file::mapped_file(const std::string &file_name)
+    : mapping(nullptr), mapping_size(0)
+{
+    const int fd = open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error(
+            "failed to open " + file_name + ": " + strerror(errno));
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0) {
+        const int err = errno;
+        close(fd);
+        throw std::runtime_error(
+            "failed to stat " + file_name + ": " + strerror(err));
+    }
+
+    mapping_size = (size_t)file_stat.st_size;
+    if (mapping_size == 0) {
+        close(fd);
+        throw std::runtime_error("cannot map empty file " + file_name);
+    }
+
+    void *addr = mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+    const int err = errno;
+    // The mapping remains valid after the descriptor is closed.
+    close(fd);
+    if (addr == MAP_FAILED) {
+        throw std::runtime_error(
+            "failed to map " + file_name + ": " + strerror(err));
+    }
+
+    mapping = (const uint8_t *)addr;
+}
+
+mapped_file::~mapped_file()
+{
+    munmap((void *)mapping, mapping_size);
+}
+
+const uint8_t *mapped_file::data() const { return mapping; }
+
+size_t mapped_file::size() const { return mapping_size; }
+
+void mapped_file::advise_sequential() const
+{
+    madvise((void *)mapping, mapping_size, MADV_SEQUENTIAL);
+    madvise((void *)mapping, mapping_size, MADV_WILLNEED);
+}
+
+} // namespace libzeth
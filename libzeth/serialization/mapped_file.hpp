@@ -0,0 +1,40 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_SERIALIZATION_MAPPED_FILE_HPP__
+#define __ZETH_SERIALIZATION_MAPPED_FILE_HPP__
+
+#include <cstdint>
+#include <stddef.h>
+#include <string>
+
+namespace libzeth
+{
+
+/// Read-only memory mapping of a whole file. The mapping is released when the
+/// object is destroyed. Throws `std::runtime_error` if the file cannot be
+/// opened or mapped.
+class mapped_file
+{
+public:
+    explicit mapped_file(const std::string &file_name);
+    ~mapped_file();
+
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    const uint8_t *data() const;
+    size_t size() const;
+
+    /// Advise the kernel that the whole mapping will be read sequentially.
+    void advise_sequential() const;
+
+private:
+    const uint8_t *mapping;
+    size_t mapping_size;
+};
+
+} // namespace libzeth
+
+#endif // __ZETH_SERIALIZATION_MAPPED_FILE_HPP__
@@ -0,0 +1,88 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_SNARKS_GROTH16_GROTH16_AFFINE_PROVING_KEY_HPP__
+#define __ZETH_SNARKS_GROTH16_GROTH16_AFFINE_PROVING_KEY_HPP__
+
+#include "libzeth/core/affine_point.hpp"
+#include "libzeth/core/array_view.hpp"
+
+#include <libsnark/zk_proof_systems/ppzksnark/r1cs_gg_ppzksnark/r1cs_gg_ppzksnark.hpp>
+#include <memory>
+#include <vector>
+
+namespace libzeth
+{
+
+/// Groth16 proving key with the query points stored in affine coordinates
+/// (x, y), instead of the Jacobian coordinates (X, Y, Z) of the libsnark
+/// proving key. The queries make up almost all of the key, so this saves a
+/// third of its memory. The points are consumed in place by the
+/// multi-exponentiations of the prover (see `multi_exp_affine`), which add
+/// them in affine or mixed coordinates.
+///
+/// The A, B and L queries are sparse: only the non-zero points are stored,
+/// with an index map giving the variable (in the assignment padded with the
+/// constant 1) of each point. Keys from the MPC, in particular, hold zero
+/// points for all the variables not appearing in A or B. The B_query of the
+/// libsnark key (a knowledge commitment vector) is stored as separate G2 and
+/// G1 arrays, sharing an index map.
+///
+/// The queries are read-only views of memory held by `storage`: either
+/// vectors owned by the key (when converted from a libsnark key), or a
+/// mapping of a file shared by several processes (see
+/// `groth16_mapped_keypair_attach`). Copies of the key share the storage.
+template<typename ppT> class groth16_affine_proving_key
+{
+public:
+    using G1_affine = affine_point<libff::G1<ppT>>;
+    using G2_affine = affine_point<libff::G2<ppT>>;
+
+    libff::G1<ppT> alpha_g1;
+    libff::G1<ppT> beta_g1;
+    libff::G2<ppT> beta_g2;
+    libff::G1<ppT> delta_g1;
+    libff::G2<ppT> delta_g2;
+
+    array_view<size_t> A_query_indices;
+    array_view<G1_affine> A_query;
+
+    size_t B_query_domain_size;
+    array_view<size_t> B_query_indices;
+    array_view<G2_affine> B_query_g2;
+    array_view<G1_affine> B_query_g1;
+
+    array_view<G1_affine> H_query;
+
+    array_view<size_t> L_query_indices;
+    array_view<G1_affine> L_query;
+
+    libsnark::r1cs_constraint_system<libff::Fr<ppT>> constraint_system;
+
+    /// Owner of the memory referenced by the queries.
+    std::shared_ptr<const void> storage;
+
+    /// Empty key, to be filled in by a loader.
+    groth16_affine_proving_key();
+
+    /// Convert a libsnark proving key. Each query of `proving_key` is
+    /// released as soon as it has been converted, so that the peak memory
+    /// usage is the size of `proving_key` plus that of its largest query.
+    explicit groth16_affine_proving_key(
+        libsnark::r1cs_gg_ppzksnark_proving_key<ppT> &&proving_key);
+
+    /// Convert back to a (dense) libsnark proving key. Throws
+    /// `std::invalid_argument` if an index of a query is out of range.
+    libsnark::r1cs_gg_ppzksnark_proving_key<ppT> to_proving_key() const;
+
+    /// Approximate number of bytes referenced by the key (excluding the
+    /// constraint system), whether or not they are shared.
+    size_t memory_size() const;
+};
+
+} // namespace libzeth
+
+#include "libzeth/snarks/groth16/groth16_affine_proving_key.tcc"
+
+#endif // __ZETH_SNARKS_GROTH16_GROTH16_AFFINE_PROVING_KEY_HPP__
@@ -0,0 +1,217 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_SNARKS_GROTH16_GROTH16_AFFINE_PROVING_KEY_TCC__
+#define __ZETH_SNARKS_GROTH16_GROTH16_AFFINE_PROVING_KEY_TCC__
+
+#include "libzeth/snarks/groth16/groth16_affine_proving_key.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace libzeth
+{
+
+namespace
+{
+
+// Storage of the queries of a key converted in this process.
+template<typename ppT> struct groth16_affine_proving_key_vectors {
+    std::vector<size_t> A_query_indices;
+    std::vector<affine_point<libff::G1<ppT>>> A_query;
+    std::vector<size_t> B_query_indices;
+    std::vector<affine_point<libff::G2<ppT>>> B_query_g2;
+    std::vector<affine_point<libff::G1<ppT>>> B_query_g1;
+    std::vector<affine_point<libff::G1<ppT>>> H_query;
+    std::vector<size_t> L_query_indices;
+    std::vector<affine_point<libff::G1<ppT>>> L_query;
+};
+
+// Convert the non-zero points of a dense query, where `points[i]`
+// corresponds to the variable `first_index + i`, and record their indices.
+template<typename GroupT>
+void groth16_affine_compact_query(
+    const std::vector<GroupT> &points,
+    size_t first_index,
+    std::vector<size_t> &indices,
+    std::vector<affine_point<GroupT>> &compact_points)
+{
+    indices.clear();
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (!points[i].is_zero()) {
+            indices.push_back(first_index + i);
+        }
+    }
+
+    compact_points.resize(indices.size());
+#ifdef MULTICORE
+#pragma omp parallel for
+#endif
+    for (size_t i = 0; i < indices.size(); ++i) {
+        compact_points[i] =
+            affine_point<GroupT>(points[indices[i] - first_index]);
+    }
+}
+
+// Dense query of `size` points (for the variables `first_index`,
+// `first_index + 1`, ...) from a sparse query.
+template<typename GroupT>
+std::vector<GroupT> groth16_affine_expand_query(
+    const array_view<size_t> &indices,
+    const array_view<affine_point<GroupT>> &compact_points,
+    size_t first_index,
+    size_t size)
+{
+    std::vector<GroupT> points(size, GroupT::zero());
+    for (size_t i = 0; i < indices.size(); ++i) {
+        if (indices[i] < first_index || indices[i] - first_index >= size) {
+            throw std::invalid_argument("proving key query index out of range");
+        }
+        points[indices[i] - first_index] = compact_points[i].to_group();
+    }
+    return points;
+}
+
+} // namespace
+
+template<typename ppT>
+groth16_affine_proving_key<ppT>::groth16_affine_proving_key()
+    : B_query_domain_size(0)
+{
+}
+
+template<typename ppT>
+groth16_affine_proving_key<ppT>::groth16_affine_proving_key(
+    libsnark::r1cs_gg_ppzksnark_proving_key<ppT> &&proving_key)
+    : alpha_g1(proving_key.alpha_g1)
+    , beta_g1(proving_key.beta_g1)
+    , beta_g2(proving_key.beta_g2)
+    , delta_g1(proving_key.delta_g1)
+    , delta_g2(proving_key.delta_g2)
+    , B_query_domain_size(proving_key.B_query.domain_size())
+    , constraint_system(std::move(proving_key.constraint_system))
+{
+    using G1 = libff::G1<ppT>;
+    using knowledge_commitment_t = libsnark::knowledge_commitment<
+        libff::G2<ppT>,
+        libff::G1<ppT>>;
+
+    std::shared_ptr<groth16_affine_proving_key_vectors<ppT>> vectors(
+        new groth16_affine_proving_key_vectors<ppT>());
+
+    groth16_affine_compact_query(
+        proving_key.A_query,
+        0,
+        vectors->A_query_indices,
+        vectors->A_query);
+    std::vector<G1>().swap(proving_key.A_query);
+
+    // B_query is already sparse, but may hold zero entries.
+    const libsnark::knowledge_commitment_vector<libff::G2<ppT>, G1> &B =
+        proving_key.B_query;
+    for (size_t i = 0; i < B.values.size(); ++i) {
+        if (!B.values[i].g.is_zero() || !B.values[i].h.is_zero()) {
+            vectors->B_query_indices.push_back(i);
+        }
+    }
+    const size_t num_b_query = vectors->B_query_indices.size();
+    vectors->B_query_g2.resize(num_b_query);
+    vectors->B_query_g1.resize(num_b_query);
+#ifdef MULTICORE
+#pragma omp parallel for
+#endif
+    for (size_t i = 0; i < num_b_query; ++i) {
+        const knowledge_commitment_t &b =
+            B.values[vectors->B_query_indices[i]];
+        vectors->B_query_g2[i] = G2_affine(b.g);
+        vectors->B_query_g1[i] = G1_affine(b.h);
+    }
+    // Map positions in B.values to variable indices.
+    for (size_t &index : vectors->B_query_indices) {
+        index = B.indices[index];
+    }
+    std::vector<size_t>().swap(proving_key.B_query.indices);
+    std::vector<knowledge_commitment_t>().swap(proving_key.B_query.values);
+
+    vectors->H_query = affine_points_from_group(proving_key.H_query);
+    std::vector<G1>().swap(proving_key.H_query);
+
+    // L_query starts at the first auxiliary variable.
+    groth16_affine_compact_query(
+        proving_key.L_query,
+        constraint_system.num_inputs() + 1,
+        vectors->L_query_indices,
+        vectors->L_query);
+    std::vector<G1>().swap(proving_key.L_query);
+
+    A_query_indices = vectors->A_query_indices;
+    A_query = vectors->A_query;
+    B_query_indices = vectors->B_query_indices;
+    B_query_g2 = vectors->B_query_g2;
+    B_query_g1 = vectors->B_query_g1;
+    H_query = vectors->H_query;
+    L_query_indices = vectors->L_query_indices;
+    L_query = vectors->L_query;
+    storage = vectors;
+}
+
+template<typename ppT>
+libsnark::r1cs_gg_ppzksnark_proving_key<ppT> groth16_affine_proving_key<
+    ppT>::to_proving_key() const
+{
+    using G1 = libff::G1<ppT>;
+    using G2 = libff::G2<ppT>;
+
+    const size_t num_variables = constraint_system.num_variables();
+    const size_t num_inputs = constraint_system.num_inputs();
+
+    libsnark::knowledge_commitment_vector<G2, G1> B_query;
+    B_query.domain_size_ = B_query_domain_size;
+    B_query.indices.assign(B_query_indices.begin(), B_query_indices.end());
+    B_query.values.reserve(B_query_indices.size());
+    for (size_t i = 0; i < B_query_indices.size(); ++i) {
+        if (B_query_indices[i] >= B_query_domain_size) {
+            throw std::invalid_argument("proving key query index out of range");
+        }
+        B_query.values.push_back(libsnark::knowledge_commitment<G2, G1>(
+            B_query_g2[i].to_group(), B_query_g1[i].to_group()));
+    }
+
+    std::vector<G1> H(H_query.size());
+    for (size_t i = 0; i < H_query.size(); ++i) {
+        H[i] = H_query[i].to_group();
+    }
+
+    return libsnark::r1cs_gg_ppzksnark_proving_key<ppT>(
+        G1(alpha_g1),
+        G1(beta_g1),
+        G2(beta_g2),
+        G1(delta_g1),
+        G2(delta_g2),
+        groth16_affine_expand_query(
+            A_query_indices, A_query, 0, num_variables + 1),
+        std::move(B_query),
+        std::move(H),
+        groth16_affine_expand_query(
+            L_query_indices,
+            L_query,
+            num_inputs + 1,
+            num_variables - num_inputs),
+        libsnark::r1cs_constraint_system<libff::Fr<ppT>>(constraint_system));
+}
+
+template<typename ppT>
+size_t groth16_affine_proving_key<ppT>::memory_size() const
+{
+    return sizeof(*this) +
+           sizeof(G1_affine) * (A_query.size() + B_query_g1.size() +
+                                H_query.size() + L_query.size()) +
+           sizeof(G2_affine) * B_query_g2.size() +
+           sizeof(size_t) * (A_query_indices.size() + B_query_indices.size() +
+                             L_query_indices.size());
+}
+
+} // namespace libzeth
+
+#endif // __ZETH_SNARKS_GROTH16_GROTH16_AFFINE_PROVING_KEY_TCC__
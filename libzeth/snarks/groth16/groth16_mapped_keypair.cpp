@@ -0,0 +1,32 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#include "libzeth/snarks/groth16/groth16_mapped_keypair.hpp"
+
+#include <cstring>
+
+namespace libzeth
+{
+
+bool groth16_mapped_keypair_detect(std::istream &in)
+{
+    // A stream shorter than the magic is not a mapped keypair, so a short
+    // read must not throw, whatever the exception mask of the stream.
+    const std::ios_base::iostate exceptions = in.exceptions();
+    in.exceptions(std::ios_base::goodbit);
+
+    const std::istream::pos_type start = in.tellg();
+    char magic[sizeof(GROTH16_MAPPED_KEYPAIR_MAGIC)];
+    in.read(magic, sizeof(magic));
+    const bool is_mapped =
+        in.good() &&
+        (0 == memcmp(magic, GROTH16_MAPPED_KEYPAIR_MAGIC, sizeof(magic)));
+    in.clear();
+    in.seekg(start);
+
+    in.exceptions(exceptions);
+    return is_mapped;
+}
+
+} // namespace libzeth
@@ -0,0 +1,132 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_SNARKS_GROTH16_GROTH16_MAPPED_KEYPAIR_HPP__
+#define __ZETH_SNARKS_GROTH16_GROTH16_MAPPED_KEYPAIR_HPP__
+
+#include "libzeth/mpc/groth16/mpc_hash.hpp"
+#include "libzeth/snarks/groth16/groth16_snark.hpp"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace libzeth
+{
+
+/// Version of the mapped keypair layout. Must be incremented whenever the
+/// layout changes.
+const uint32_t GROTH16_MAPPED_KEYPAIR_VERSION = 3;
+
+/// Magic bytes at the start of a mapped keypair file.
+const char GROTH16_MAPPED_KEYPAIR_MAGIC[8] = {
+    'Z', 'E', 'T', 'H', 'G', '1', '6', 'M'};
+
+/// Alignment (in bytes) of each section of a mapped keypair file.
+const size_t GROTH16_MAPPED_KEYPAIR_ALIGNMENT = 64;
+
+/// Header of a mapped keypair file. The header is followed by a payload made
+/// of aligned sections, in the order:
+///
+///   G1 generator (used to detect a curve or representation mismatch),
+///   alpha_g1, beta_g1, beta_g2, delta_g1, delta_g2,
+///   A_query indices, A_query,
+///   B_query indices, B_query G2 values, B_query G1 values,
+///   H_query,
+///   L_query indices, L_query,
+///   number of terms of each linear combination of the constraint system,
+///   all linear terms of the constraint system,
+///   the verification key (in the libff byte format).
+///
+/// Group and field elements are stored as their in-memory representation
+/// (Montgomery form), so that loading the key does not involve any parsing
+/// or point decompression. Individual points are normalized so that Z = 1,
+/// and the points of the queries are stored in affine coordinates (as
+/// `affine_point`), in the layout used by `groth16_affine_proving_key`. The
+/// A, B and L queries only hold their non-zero points, each preceded by the
+/// (64-bit) indices of the corresponding variables. As a consequence of
+/// this layout, files are specific to the curve, the build configuration
+/// and the host architecture. The sizes recorded in the header are used to
+/// detect incompatible files.
+struct groth16_mapped_keypair_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+
+    uint64_t g1_size;
+    uint64_t g2_size;
+    uint64_t fr_size;
+
+    /// Number of points stored for each query, and number of variables
+    /// covered by the sparse queries.
+    uint64_t num_a_query;
+    uint64_t a_query_size;
+    uint64_t num_b_query;
+    uint64_t b_query_domain_size;
+    uint64_t num_h_query;
+    uint64_t num_l_query;
+    uint64_t l_query_size;
+
+    uint64_t primary_input_size;
+    uint64_t auxiliary_input_size;
+    uint64_t num_constraints;
+    uint64_t num_terms;
+
+    uint64_t vk_size;
+    uint64_t payload_size;
+
+    /// BLAKE2b hash of the payload
+    mpc_hash_t checksum;
+};
+
+/// Checks to perform when loading a mapped keypair.
+struct groth16_mapped_keypair_checks {
+    /// Recompute the payload hash and compare it to the header.
+    bool verify_checksum;
+    /// Check that all group elements are well-formed (in parallel, when built
+    /// with MULTICORE).
+    bool check_well_formed;
+};
+
+/// Returns true if the stream starts with the magic bytes of the mapped
+/// keypair format. The stream position is restored. Streams shorter than the
+/// magic are reported as not mapped, even if their exceptions are enabled.
+bool groth16_mapped_keypair_detect(std::istream &in);
+
+/// Write a keypair in the mapped layout. The proving key points are
+/// normalized (converted to affine form) before being written. The header is
+/// written last, so `out` must be seekable (e.g. an std::ofstream).
+template<typename ppT>
+std::ostream &groth16_mapped_keypair_write(
+    const typename groth16_snark<ppT>::KeypairT &keypair, std::ostream &out);
+
+/// Load a keypair written by `groth16_mapped_keypair_write`. The file is
+/// memory-mapped and the proving key is copied out of the mapping without
+/// any parsing.
+template<typename ppT>
+typename groth16_snark<ppT>::KeypairT groth16_mapped_keypair_load(
+    const std::string &file_name, const groth16_mapped_keypair_checks &checks);
+
+/// Attach to a keypair written by `groth16_mapped_keypair_write`, without
+/// copying the proving key queries. The file is mapped read-only and shared,
+/// and the queries of the returned key point into the mapping, which is kept
+/// alive by the key. All processes attaching to the same file (for example
+/// in /dev/shm) share a single copy of the queries in memory. The constraint
+/// system and the verification key (written to `vk`) are copied.
+template<typename ppT>
+typename groth16_snark<ppT>::AffineProvingKeyT groth16_mapped_keypair_attach(
+    const std::string &file_name,
+    const groth16_mapped_keypair_checks &checks,
+    typename groth16_snark<ppT>::VerificationKeyT &vk);
+
+/// Check well-formedness of a proving key, using all available cores.
+template<typename ppT>
+bool groth16_proving_key_is_well_formed_parallel(
+    const typename groth16_snark<ppT>::ProvingKeyT &pk);
+
+} // namespace libzeth
+
+#include "libzeth/snarks/groth16/groth16_mapped_keypair.tcc"
+
+#endif // __ZETH_SNARKS_GROTH16_GROTH16_MAPPED_KEYPAIR_HPP__
@@ -0,0 +1,694 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_SNARKS_GROTH16_GROTH16_MAPPED_KEYPAIR_TCC__
+#define __ZETH_SNARKS_GROTH16_GROTH16_MAPPED_KEYPAIR_TCC__
+
+#include "libzeth/core/affine_point.hpp"
+#include "libzeth/core/array_view.hpp"
+#include "libzeth/serialization/mapped_file.hpp"
+#include "libzeth/snarks/groth16/groth16_mapped_keypair.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <type_traits>
+
+namespace libzeth
+{
+
+namespace
+{
+
+inline size_t mapped_padding(size_t offset)
+{
+    return (GROTH16_MAPPED_KEYPAIR_ALIGNMENT -
+            (offset % GROTH16_MAPPED_KEYPAIR_ALIGNMENT)) %
+           GROTH16_MAPPED_KEYPAIR_ALIGNMENT;
+}
+
+// Pad the stream to the section alignment.
+inline void mapped_write_padding(std::ostream &out, size_t &offset)
+{
+    static const char zeros[GROTH16_MAPPED_KEYPAIR_ALIGNMENT] = {0};
+    const size_t padding = mapped_padding(offset);
+    out.write(zeros, padding);
+    offset += padding;
+}
+
+template<typename T>
+void mapped_write_value(std::ostream &out, size_t &offset, const T &value)
+{
+    out.write((const char *)&value, sizeof(T));
+    offset += sizeof(T);
+}
+
+// Write a single point, normalized so that Z = 1.
+template<typename GroupT>
+void mapped_write_point(std::ostream &out, size_t &offset, const GroupT &point)
+{
+    GroupT normalized = point;
+    if (!normalized.is_special()) {
+        normalized.to_special();
+    }
+    mapped_write_value(out, offset, normalized);
+}
+
+// Write `num_points` points (the i-th being `get_point(i)`) in affine
+// coordinates, as an aligned section. Points are converted in batches, in
+// parallel.
+template<typename GroupT, typename GetPointFn>
+void mapped_write_affine_points(
+    std::ostream &out,
+    size_t &offset,
+    size_t num_points,
+    const GetPointFn &get_point)
+{
+    const size_t batch_size = 1 << 16;
+    std::vector<affine_point<GroupT>> batch;
+    for (size_t begin = 0; begin < num_points; begin += batch_size) {
+        const size_t end = std::min(begin + batch_size, num_points);
+        batch.resize(end - begin);
+#ifdef MULTICORE
+#pragma omp parallel for
+#endif
+        for (size_t i = begin; i < end; ++i) {
+            batch[i - begin] = affine_point<GroupT>(get_point(i));
+        }
+        const size_t num_bytes = batch.size() * sizeof(affine_point<GroupT>);
+        out.write((const char *)batch.data(), num_bytes);
+        offset += num_bytes;
+    }
+    mapped_write_padding(out, offset);
+}
+
+template<typename GroupT>
+void mapped_write_affine_points(
+    std::ostream &out, size_t &offset, const std::vector<GroupT> &points)
+{
+    mapped_write_affine_points<GroupT>(
+        out, offset, points.size(), [&points](size_t i) -> const GroupT & {
+            return points[i];
+        });
+}
+
+// Indices (starting at `first_index`) of the non-zero points of a dense
+// query.
+template<typename GroupT>
+std::vector<size_t> mapped_non_zero_indices(
+    const std::vector<GroupT> &points, size_t first_index)
+{
+    std::vector<size_t> indices;
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (!points[i].is_zero()) {
+            indices.push_back(first_index + i);
+        }
+    }
+    return indices;
+}
+
+inline void mapped_write_indices(
+    std::ostream &out, size_t &offset, const std::vector<size_t> &indices)
+{
+    for (const size_t index : indices) {
+        const uint64_t index_u64 = index;
+        mapped_write_value(out, offset, index_u64);
+    }
+    mapped_write_padding(out, offset);
+}
+
+// Write the non-zero points of a dense query, preceded by their indices.
+template<typename GroupT>
+void mapped_write_sparse_affine_points(
+    std::ostream &out,
+    size_t &offset,
+    const std::vector<GroupT> &points,
+    const std::vector<size_t> &indices,
+    size_t first_index)
+{
+    mapped_write_indices(out, offset, indices);
+    mapped_write_affine_points<GroupT>(
+        out,
+        offset,
+        indices.size(),
+        [&points, &indices, first_index](size_t i) -> const GroupT & {
+            return points[indices[i] - first_index];
+        });
+}
+
+// Bounds-checked reader for the payload of a mapped file.
+class mapped_reader
+{
+public:
+    mapped_reader(const uint8_t *data, size_t size)
+        : data(data), size(size), offset(0)
+    {
+    }
+
+    const uint8_t *take(size_t num_bytes)
+    {
+        if (num_bytes > size - offset) {
+            throw std::invalid_argument("mapped keypair file is truncated");
+        }
+        const uint8_t *ptr = data + offset;
+        offset += num_bytes;
+        return ptr;
+    }
+
+    template<typename T> void read_value(T &value)
+    {
+        memcpy((void *)&value, take(sizeof(T)), sizeof(T));
+    }
+
+    template<typename T> void read_values(std::vector<T> &values, size_t num)
+    {
+        values.resize(num);
+        if (num != 0) {
+            const size_t num_bytes = num * sizeof(T);
+            memcpy((void *)values.data(), take(num_bytes), num_bytes);
+        }
+    }
+
+    // View of `num` values in place, followed by the section padding. Only
+    // used at the start of sections, which are suitably aligned.
+    template<typename T> array_view<T> view_values(size_t num)
+    {
+        const T *values = (const T *)take(num * sizeof(T));
+        skip_padding();
+        return array_view<T>(values, num);
+    }
+
+    // Read a section of `num` points in affine coordinates, passing each one
+    // (in libff's representation) to `set_point(i, point)`.
+    template<typename GroupT, typename SetPointFn>
+    void read_affine_points(size_t num, const SetPointFn &set_point)
+    {
+        const array_view<affine_point<GroupT>> points =
+            view_values<affine_point<GroupT>>(num);
+#ifdef MULTICORE
+#pragma omp parallel for
+#endif
+        for (size_t i = 0; i < num; ++i) {
+            set_point(i, points[i].to_group());
+        }
+    }
+
+    template<typename GroupT>
+    void read_affine_points(std::vector<GroupT> &points, size_t num)
+    {
+        points.resize(num);
+        read_affine_points<GroupT>(
+            num, [&points](size_t i, const GroupT &point) {
+                points[i] = point;
+            });
+    }
+
+    // Read a sparse query of `num` points, expanding it into `size` points
+    // (for the variables `first_index`, `first_index + 1`, ...).
+    template<typename GroupT>
+    void read_sparse_affine_points(
+        std::vector<GroupT> &points,
+        size_t num,
+        size_t size,
+        size_t first_index)
+    {
+        const array_view<uint64_t> indices = view_values<uint64_t>(num);
+        for (const uint64_t index : indices) {
+            if (index < first_index || index - first_index >= size) {
+                throw std::invalid_argument(
+                    "mapped keypair query index out of range");
+            }
+        }
+        points.assign(size, GroupT::zero());
+        read_affine_points<GroupT>(
+            num,
+            [&points, &indices, first_index](size_t i, const GroupT &point) {
+                points[indices[i] - first_index] = point;
+            });
+    }
+
+    void skip_padding() { take(mapped_padding(offset)); }
+
+private:
+    const uint8_t *data;
+    const size_t size;
+    size_t offset;
+};
+
+template<typename GroupT>
+bool parallel_container_is_well_formed(const std::vector<GroupT> &values)
+{
+    bool result = true;
+#ifdef MULTICORE
+#pragma omp parallel for reduction(&& : result)
+#endif
+    for (size_t i = 0; i < values.size(); ++i) {
+        result = result && values[i].is_well_formed();
+    }
+    return result;
+}
+
+template<typename GroupT>
+bool parallel_affine_points_are_well_formed(
+    const array_view<affine_point<GroupT>> &points)
+{
+    bool result = true;
+#ifdef MULTICORE
+#pragma omp parallel for reduction(&& : result)
+#endif
+    for (size_t i = 0; i < points.size(); ++i) {
+        result = result && points[i].to_group().is_well_formed();
+    }
+    return result;
+}
+
+// Check that the indices of a sparse query are strictly increasing and in
+// [first_index, end_index), so that the prover can use them to index the
+// assignment.
+template<typename IndexT>
+void mapped_check_query_indices(
+    const array_view<IndexT> &indices, size_t first_index, size_t end_index)
+{
+    size_t min_index = first_index;
+    for (const IndexT index : indices) {
+        if (index < min_index || index >= end_index) {
+            throw std::invalid_argument(
+                "mapped keypair query indices out of range or not sorted");
+        }
+        min_index = index + 1;
+    }
+}
+
+// Check the header of a mapped keypair file and (if requested) the checksum
+// of its payload. Returns a pointer to the payload.
+template<typename ppT>
+const uint8_t *mapped_keypair_payload(
+    const mapped_file &file,
+    const groth16_mapped_keypair_checks &checks,
+    groth16_mapped_keypair_header &header)
+{
+    using G1 = libff::G1<ppT>;
+    using G2 = libff::G2<ppT>;
+    using FieldT = libff::Fr<ppT>;
+
+    if (file.size() < sizeof(header)) {
+        throw std::invalid_argument("mapped keypair file is truncated");
+    }
+    memcpy(&header, file.data(), sizeof(header));
+    if (0 != memcmp(
+                 header.magic,
+                 GROTH16_MAPPED_KEYPAIR_MAGIC,
+                 sizeof(GROTH16_MAPPED_KEYPAIR_MAGIC))) {
+        throw std::invalid_argument("not a mapped keypair file");
+    }
+    if (header.version != GROTH16_MAPPED_KEYPAIR_VERSION) {
+        throw std::invalid_argument("unsupported mapped keypair version");
+    }
+    if (header.g1_size != sizeof(G1) || header.g2_size != sizeof(G2) ||
+        header.fr_size != sizeof(FieldT)) {
+        throw std::invalid_argument(
+            "mapped keypair was written for another curve or configuration");
+    }
+    if (header.header_size < sizeof(header) ||
+        (uint64_t)header.header_size + header.payload_size != file.size()) {
+        throw std::invalid_argument("mapped keypair file has invalid size");
+    }
+
+    const uint8_t *payload = file.data() + header.header_size;
+    if (checks.verify_checksum) {
+        mpc_hash_t checksum;
+        mpc_compute_hash(checksum, payload, header.payload_size);
+        if (0 != memcmp(checksum, header.checksum, sizeof(checksum))) {
+            throw std::invalid_argument("mapped keypair checksum mismatch");
+        }
+    }
+    return payload;
+}
+
+// Read the generator (checking that it matches the curve) and the individual
+// elements of a proving key (of either representation).
+template<typename ppT, typename ProvingKeyT>
+void mapped_read_key_elements(mapped_reader &reader, ProvingKeyT &pk)
+{
+    using G1 = libff::G1<ppT>;
+
+    G1 generator;
+    reader.read_value(generator);
+    if (!(generator == G1::one())) {
+        throw std::invalid_argument(
+            "mapped keypair was written for another curve or configuration");
+    }
+
+    reader.read_value(pk.alpha_g1);
+    reader.read_value(pk.beta_g1);
+    reader.read_value(pk.beta_g2);
+    reader.read_value(pk.delta_g1);
+    reader.read_value(pk.delta_g2);
+    reader.skip_padding();
+}
+
+// Read the sections following the queries: the constraint system and the
+// verification key.
+template<typename ppT>
+typename groth16_snark<ppT>::VerificationKeyT mapped_read_constraint_system(
+    mapped_reader &reader,
+    const groth16_mapped_keypair_header &header,
+    libsnark::r1cs_constraint_system<libff::Fr<ppT>> &cs)
+{
+    std::vector<uint64_t> lc_sizes;
+    reader.read_values(lc_sizes, 3 * header.num_constraints);
+    reader.skip_padding();
+
+    uint64_t num_terms = 0;
+    for (const uint64_t lc_size : lc_sizes) {
+        num_terms += lc_size;
+    }
+    if (num_terms != header.num_terms) {
+        throw std::invalid_argument(
+            "mapped keypair constraint system does not match the header");
+    }
+
+    cs.primary_input_size = header.primary_input_size;
+    cs.auxiliary_input_size = header.auxiliary_input_size;
+    cs.constraints.resize(header.num_constraints);
+    for (size_t i = 0; i < header.num_constraints; ++i) {
+        libsnark::r1cs_constraint<libff::Fr<ppT>> &constraint =
+            cs.constraints[i];
+        reader.read_values(constraint.a.terms, lc_sizes[3 * i]);
+        reader.read_values(constraint.b.terms, lc_sizes[3 * i + 1]);
+        reader.read_values(constraint.c.terms, lc_sizes[3 * i + 2]);
+    }
+    reader.skip_padding();
+
+    const uint8_t *vk_bytes = reader.take(header.vk_size);
+    std::istringstream vk_stream(
+        std::string((const char *)vk_bytes, header.vk_size));
+    return groth16_snark<ppT>::verification_key_read_bytes(vk_stream);
+}
+
+} // namespace
+
+template<typename ppT>
+std::ostream &groth16_mapped_keypair_write(
+    const typename groth16_snark<ppT>::KeypairT &keypair, std::ostream &out)
+{
+    using G1 = libff::G1<ppT>;
+    using G2 = libff::G2<ppT>;
+    using FieldT = libff::Fr<ppT>;
+    static_assert(
+        std::is_trivially_copyable<G1>::value &&
+            std::is_trivially_copyable<G2>::value &&
+            std::is_trivially_copyable<affine_point<G1>>::value &&
+            std::is_trivially_copyable<affine_point<G2>>::value &&
+            std::is_trivially_copyable<libsnark::linear_term<FieldT>>::value,
+        "mapped keypair format requires trivially copyable elements");
+
+    const typename groth16_snark<ppT>::ProvingKeyT &pk = keypair.pk;
+    const libsnark::r1cs_constraint_system<FieldT> &cs = pk.constraint_system;
+
+    std::ostringstream vk_stream;
+    groth16_snark<ppT>::verification_key_write_bytes(keypair.vk, vk_stream);
+    const std::string vk_bytes = vk_stream.str();
+
+    groth16_mapped_keypair_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(
+        header.magic,
+        GROTH16_MAPPED_KEYPAIR_MAGIC,
+        sizeof(GROTH16_MAPPED_KEYPAIR_MAGIC));
+    header.version = GROTH16_MAPPED_KEYPAIR_VERSION;
+    header.header_size =
+        (uint32_t)(sizeof(header) + mapped_padding(sizeof(header)));
+    header.g1_size = sizeof(G1);
+    header.g2_size = sizeof(G2);
+    header.fr_size = sizeof(FieldT);
+
+    // Only the non-zero points of the A, B and L queries are written. The
+    // positions of those of B_query are relative to B_query.values, and its
+    // indices are those of the corresponding variables.
+    const size_t l_first_index = cs.num_inputs() + 1;
+    const std::vector<size_t> a_indices =
+        mapped_non_zero_indices(pk.A_query, 0);
+    std::vector<size_t> b_positions;
+    std::vector<size_t> b_indices;
+    for (size_t i = 0; i < pk.B_query.values.size(); ++i) {
+        if (!pk.B_query.values[i].g.is_zero() ||
+            !pk.B_query.values[i].h.is_zero()) {
+            b_positions.push_back(i);
+            b_indices.push_back(pk.B_query.indices[i]);
+        }
+    }
+    const std::vector<size_t> l_indices =
+        mapped_non_zero_indices(pk.L_query, l_first_index);
+
+    header.num_a_query = a_indices.size();
+    header.a_query_size = pk.A_query.size();
+    header.num_b_query = b_indices.size();
+    header.b_query_domain_size = pk.B_query.domain_size();
+    header.num_h_query = pk.H_query.size();
+    header.num_l_query = l_indices.size();
+    header.l_query_size = pk.L_query.size();
+    header.primary_input_size = cs.primary_input_size;
+    header.auxiliary_input_size = cs.auxiliary_input_size;
+    header.num_constraints = cs.constraints.size();
+    header.vk_size = vk_bytes.size();
+
+    // Placeholder header, rewritten once the payload size and hash are known.
+    const std::ostream::pos_type start = out.tellp();
+    size_t header_offset = 0;
+    mapped_write_value(out, header_offset, header);
+    mapped_write_padding(out, header_offset);
+
+    // Payload. Only the payload is hashed.
+    mpc_hash_ostream_wrapper hash_out(out);
+    size_t offset = 0;
+
+    mapped_write_point(hash_out, offset, G1::one());
+    mapped_write_point(hash_out, offset, pk.alpha_g1);
+    mapped_write_point(hash_out, offset, pk.beta_g1);
+    mapped_write_point(hash_out, offset, pk.beta_g2);
+    mapped_write_point(hash_out, offset, pk.delta_g1);
+    mapped_write_point(hash_out, offset, pk.delta_g2);
+    mapped_write_padding(hash_out, offset);
+
+    mapped_write_sparse_affine_points(
+        hash_out, offset, pk.A_query, a_indices, 0);
+
+    mapped_write_indices(hash_out, offset, b_indices);
+    mapped_write_affine_points<G2>(
+        hash_out,
+        offset,
+        b_positions.size(),
+        [&pk, &b_positions](size_t i) -> const G2 & {
+            return pk.B_query.values[b_positions[i]].g;
+        });
+    mapped_write_affine_points<G1>(
+        hash_out,
+        offset,
+        b_positions.size(),
+        [&pk, &b_positions](size_t i) -> const G1 & {
+            return pk.B_query.values[b_positions[i]].h;
+        });
+
+    mapped_write_affine_points(hash_out, offset, pk.H_query);
+    mapped_write_sparse_affine_points(
+        hash_out, offset, pk.L_query, l_indices, l_first_index);
+
+    for (const libsnark::r1cs_constraint<FieldT> &constraint :
+         cs.constraints) {
+        const uint64_t a_size = constraint.a.terms.size();
+        const uint64_t b_size = constraint.b.terms.size();
+        const uint64_t c_size = constraint.c.terms.size();
+        mapped_write_value(hash_out, offset, a_size);
+        mapped_write_value(hash_out, offset, b_size);
+        mapped_write_value(hash_out, offset, c_size);
+    }
+    mapped_write_padding(hash_out, offset);
+
+    size_t num_terms = 0;
+    for (const libsnark::r1cs_constraint<FieldT> &constraint :
+         cs.constraints) {
+        for (const libsnark::linear_combination<FieldT> *lc :
+             {&constraint.a, &constraint.b, &constraint.c}) {
+            const size_t lc_size =
+                lc->terms.size() * sizeof(libsnark::linear_term<FieldT>);
+            hash_out.write((const char *)lc->terms.data(), lc_size);
+            offset += lc_size;
+            num_terms += lc->terms.size();
+        }
+    }
+    mapped_write_padding(hash_out, offset);
+
+    hash_out.write(vk_bytes.data(), vk_bytes.size());
+    offset += vk_bytes.size();
+    mapped_write_padding(hash_out, offset);
+
+    // Rewrite the header, now that the payload is complete.
+    header.num_terms = num_terms;
+    header.payload_size = offset;
+    hash_out.get_hash(header.checksum);
+
+    const std::ostream::pos_type end = out.tellp();
+    out.seekp(start);
+    out.write((const char *)&header, sizeof(header));
+    out.seekp(end);
+    return out;
+}
+
+template<typename ppT>
+typename groth16_snark<ppT>::KeypairT groth16_mapped_keypair_load(
+    const std::string &file_name, const groth16_mapped_keypair_checks &checks)
+{
+    using G1 = libff::G1<ppT>;
+    using G2 = libff::G2<ppT>;
+
+    const mapped_file file(file_name);
+    file.advise_sequential();
+
+    groth16_mapped_keypair_header header;
+    const uint8_t *payload =
+        mapped_keypair_payload<ppT>(file, checks, header);
+    mapped_reader reader(payload, header.payload_size);
+
+    typename groth16_snark<ppT>::ProvingKeyT pk;
+    mapped_read_key_elements<ppT>(reader, pk);
+
+    // The A and L queries are expanded to dense vectors, as expected by the
+    // libsnark prover.
+    reader.read_sparse_affine_points(
+        pk.A_query, header.num_a_query, header.a_query_size, 0);
+
+    std::vector<uint64_t> b_indices;
+    reader.read_values(b_indices, header.num_b_query);
+    mapped_check_query_indices(
+        array_view<uint64_t>(b_indices), 0, header.b_query_domain_size);
+    pk.B_query.indices.assign(b_indices.begin(), b_indices.end());
+    reader.skip_padding();
+    pk.B_query.values.resize(header.num_b_query);
+    reader.read_affine_points<G2>(
+        header.num_b_query, [&pk](size_t i, const G2 &point) {
+            pk.B_query.values[i].g = point;
+        });
+    reader.read_affine_points<G1>(
+        header.num_b_query, [&pk](size_t i, const G1 &point) {
+            pk.B_query.values[i].h = point;
+        });
+    pk.B_query.domain_size_ = header.b_query_domain_size;
+
+    reader.read_affine_points(pk.H_query, header.num_h_query);
+    reader.read_sparse_affine_points(
+        pk.L_query,
+        header.num_l_query,
+        header.l_query_size,
+        header.primary_input_size + 1);
+
+    typename groth16_snark<ppT>::VerificationKeyT vk =
+        mapped_read_constraint_system<ppT>(
+            reader, header, pk.constraint_system);
+
+    if (checks.check_well_formed &&
+        !groth16_proving_key_is_well_formed_parallel<ppT>(pk)) {
+        throw std::invalid_argument("proving key (read) not well-formed");
+    }
+
+    return
+        typename groth16_snark<ppT>::KeypairT(std::move(pk), std::move(vk));
+}
+
+template<typename ppT>
+typename groth16_snark<ppT>::AffineProvingKeyT groth16_mapped_keypair_attach(
+    const std::string &file_name,
+    const groth16_mapped_keypair_checks &checks,
+    typename groth16_snark<ppT>::VerificationKeyT &vk)
+{
+    using G1 = libff::G1<ppT>;
+    using G2 = libff::G2<ppT>;
+    using G1_affine = affine_point<G1>;
+    using G2_affine = affine_point<G2>;
+    static_assert(
+        sizeof(size_t) == sizeof(uint64_t),
+        "query indices are viewed in place");
+
+    std::shared_ptr<const mapped_file> file(new mapped_file(file_name));
+
+    groth16_mapped_keypair_header header;
+    const uint8_t *payload =
+        mapped_keypair_payload<ppT>(*file, checks, header);
+    mapped_reader reader(payload, header.payload_size);
+
+    typename groth16_snark<ppT>::AffineProvingKeyT pk;
+    mapped_read_key_elements<ppT>(reader, pk);
+
+    pk.A_query_indices = reader.view_values<size_t>(header.num_a_query);
+    pk.A_query = reader.view_values<G1_affine>(header.num_a_query);
+    pk.B_query_domain_size = header.b_query_domain_size;
+    pk.B_query_indices = reader.view_values<size_t>(header.num_b_query);
+    pk.B_query_g2 = reader.view_values<G2_affine>(header.num_b_query);
+    pk.B_query_g1 = reader.view_values<G1_affine>(header.num_b_query);
+    pk.H_query = reader.view_values<G1_affine>(header.num_h_query);
+    pk.L_query_indices = reader.view_values<size_t>(header.num_l_query);
+    pk.L_query = reader.view_values<G1_affine>(header.num_l_query);
+
+    // The queries are used in place, so their indices are checked here,
+    // against the assignment (padded with the constant 1) they index.
+    const size_t assignment_size =
+        header.primary_input_size + header.auxiliary_input_size + 1;
+    mapped_check_query_indices(pk.A_query_indices, 0, assignment_size);
+    mapped_check_query_indices(
+        pk.B_query_indices,
+        0,
+        std::min<size_t>(header.b_query_domain_size, assignment_size));
+    mapped_check_query_indices(
+        pk.L_query_indices, header.primary_input_size + 1, assignment_size);
+
+    vk = mapped_read_constraint_system<ppT>(
+        reader, header, pk.constraint_system);
+
+    if (checks.check_well_formed) {
+        const bool well_formed =
+            pk.alpha_g1.is_well_formed() && pk.beta_g1.is_well_formed() &&
+            pk.beta_g2.is_well_formed() && pk.delta_g1.is_well_formed() &&
+            pk.delta_g2.is_well_formed() &&
+            parallel_affine_points_are_well_formed(pk.A_query) &&
+            parallel_affine_points_are_well_formed(pk.B_query_g2) &&
+            parallel_affine_points_are_well_formed(pk.B_query_g1) &&
+            parallel_affine_points_are_well_formed(pk.H_query) &&
+            parallel_affine_points_are_well_formed(pk.L_query);
+        if (!well_formed) {
+            throw std::invalid_argument("proving key (read) not well-formed");
+        }
+    }
+
+    pk.storage = file;
+    return pk;
+}
+
+template<typename ppT>
+bool groth16_proving_key_is_well_formed_parallel(
+    const typename groth16_snark<ppT>::ProvingKeyT &pk)
+{
+    if (!pk.alpha_g1.is_well_formed() || !pk.beta_g1.is_well_formed() ||
+        !pk.beta_g2.is_well_formed() || !pk.delta_g1.is_well_formed() ||
+        !pk.delta_g2.is_well_formed() ||
+        !parallel_container_is_well_formed(pk.A_query) ||
+        !parallel_container_is_well_formed(pk.H_query) ||
+        !parallel_container_is_well_formed(pk.L_query)) {
+        return false;
+    }
+
+    bool result = true;
+#ifdef MULTICORE
+#pragma omp parallel for reduction(&& : result)
+#endif
+    for (size_t i = 0; i < pk.B_query.values.size(); ++i) {
+        result = result && pk.B_query.values[i].g.is_well_formed() &&
+                 pk.B_query.values[i].h.is_well_formed();
+    }
+    return result;
+}
+
+} // namespace libzeth
+
+#endif // __ZETH_SNARKS_GROTH16_GROTH16_MAPPED_KEYPAIR_TCC__
@@ -0,0 +1,43 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_SNARKS_GROTH16_GROTH16_PREPARED_VERIFICATION_KEY_HPP__
+#define __ZETH_SNARKS_GROTH16_GROTH16_PREPARED_VERIFICATION_KEY_HPP__
+
+#include <libff/algebra/curves/public_params.hpp>
+#include <libsnark/zk_proof_systems/ppzksnark/r1cs_gg_ppzksnark/r1cs_gg_ppzksnark.hpp>
+
+namespace libzeth
+{
+
+/// Groth16 verification key in a form ready for the pairing checks. A proof
+/// (A, B, C) for inputs with accumulation IC is valid iff:
+///
+///   e(A, B) * e(IC, -gamma) * e(C, -delta) = e(alpha, beta)
+///
+/// The right-hand side, and the Miller loop precomputations (line
+/// coefficients) of -gamma and -delta, depend only on the key. They are
+/// computed once here, so that each verification only needs the Miller loops
+/// involving the proof and a single final exponentiation. (In the variant of
+/// Groth16 used by Zeth, gamma is the generator of G2.)
+template<typename ppT> class groth16_prepared_verification_key
+{
+public:
+    libff::GT<ppT> alpha_g1_beta_g2;
+    libff::G2_precomp<ppT> minus_gamma_g2_precomp;
+    libff::G2_precomp<ppT> minus_delta_g2_precomp;
+    libsnark::accumulation_vector<libff::G1<ppT>> ABC_g1;
+
+    explicit groth16_prepared_verification_key(
+        const libsnark::r1cs_gg_ppzksnark_verification_key<ppT> &vk);
+
+    /// Number of primary inputs accepted by the key
+    size_t num_primary_inputs() const;
+};
+
+} // namespace libzeth
+
+#include "libzeth/snarks/groth16/groth16_prepared_verification_key.tcc"
+
+#endif // __ZETH_SNARKS_GROTH16_GROTH16_PREPARED_VERIFICATION_KEY_HPP__
@@ -0,0 +1,31 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_SNARKS_GROTH16_GROTH16_PREPARED_VERIFICATION_KEY_TCC__
+#define __ZETH_SNARKS_GROTH16_GROTH16_PREPARED_VERIFICATION_KEY_TCC__
+
+#include "libzeth/snarks/groth16/groth16_prepared_verification_key.hpp"
+
+namespace libzeth
+{
+
+template<typename ppT>
+groth16_prepared_verification_key<ppT>::groth16_prepared_verification_key(
+    const libsnark::r1cs_gg_ppzksnark_verification_key<ppT> &vk)
+    : alpha_g1_beta_g2(ppT::reduced_pairing(vk.alpha_g1, vk.beta_g2))
+    , minus_gamma_g2_precomp(ppT::precompute_G2(-libff::G2<ppT>::one()))
+    , minus_delta_g2_precomp(ppT::precompute_G2(-vk.delta_g2))
+    , ABC_g1(vk.ABC_g1)
+{
+}
+
+template<typename ppT>
+size_t groth16_prepared_verification_key<ppT>::num_primary_inputs() const
+{
+    return ABC_g1.domain_size();
+}
+
+} // namespace libzeth
+
+#endif // __ZETH_SNARKS_GROTH16_GROTH16_PREPARED_VERIFICATION_KEY_TCC__
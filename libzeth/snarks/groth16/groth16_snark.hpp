@@ -5,6 +5,10 @@
 #ifndef __ZETH_SNARKS_GROTH16_GROTH16_SNARK_HPP__
 #define __ZETH_SNARKS_GROTH16_GROTH16_SNARK_HPP__
 
+#include "libzeth/core/cancellation.hpp"
+#include "libzeth/snarks/groth16/groth16_affine_proving_key.hpp"
+#include "libzeth/snarks/groth16/groth16_prepared_verification_key.hpp"
+
 #include <libsnark/gadgetlib1/protoboard.hpp>
 #include <libsnark/zk_proof_systems/ppzksnark/r1cs_gg_ppzksnark/r1cs_gg_ppzksnark.hpp>
 
@@ -19,6 +23,8 @@ public:
     typedef libsnark::r1cs_gg_ppzksnark_verification_key<ppT> VerificationKeyT;
     typedef libsnark::r1cs_gg_ppzksnark_keypair<ppT> KeypairT;
     typedef libsnark::r1cs_gg_ppzksnark_proof<ppT> ProofT;
+    typedef groth16_prepared_verification_key<ppT> PreparedVerificationKeyT;
+    typedef groth16_affine_proving_key<ppT> AffineProvingKeyT;
 
     /// Run the trusted setup and return the keypair for the circuit
     static KeypairT generate_setup(
@@ -29,12 +35,61 @@ public:
         const libsnark::protoboard<libff::Fr<ppT>> &pb,
         const ProvingKeyT &proving_key);
 
+    /// Generate the proof from an assignment which has already been extracted
+    /// from a protoboard.
+    static ProofT generate_proof(
+        const ProvingKeyT &proving_key,
+        const libsnark::r1cs_primary_input<libff::Fr<ppT>> &primary_input,
+        const libsnark::r1cs_auxiliary_input<libff::Fr<ppT>> &auxiliary_input);
+
+    /// Generate the proof from an assignment, checking `cancellation` between
+    /// the phases of the prover (constraint evaluation, each FFT and each
+    /// multi-exponentiation). Throws `operation_cancelled` if the token is
+    /// cancelled before the proof is complete.
+    static ProofT generate_proof(
+        const ProvingKeyT &proving_key,
+        const libsnark::r1cs_primary_input<libff::Fr<ppT>> &primary_input,
+        const libsnark::r1cs_auxiliary_input<libff::Fr<ppT>> &auxiliary_input,
+        const cancellation_token &cancellation);
+
+    /// Generate the proof using a proving key stored in affine coordinates.
+    /// The result is the same as with the equivalent `ProvingKeyT`, with
+    /// lower memory usage. `cancellation` is checked as above.
+    static ProofT generate_proof(
+        const AffineProvingKeyT &proving_key,
+        const libsnark::r1cs_primary_input<libff::Fr<ppT>> &primary_input,
+        const libsnark::r1cs_auxiliary_input<libff::Fr<ppT>> &auxiliary_input,
+        const cancellation_token &cancellation);
+
     /// Verify proof
     static bool verify(
         const libsnark::r1cs_primary_input<libff::Fr<ppT>> &primary_inputs,
         const ProofT &proof,
         const VerificationKeyT &verification_key);
 
+    /// Precompute the values used by the verifier (pairing of alpha and beta,
+    /// G2 precomputations for gamma and delta), so that they can be reused
+    /// across calls to `verify` and `verify_batch`.
+    static PreparedVerificationKeyT prepare_verification_key(
+        const VerificationKeyT &verification_key);
+
+    /// Verify proof, using a prepared verification key. Requires three
+    /// Miller loops and one final exponentiation.
+    static bool verify(
+        const libsnark::r1cs_primary_input<libff::Fr<ppT>> &primary_inputs,
+        const ProofT &proof,
+        const PreparedVerificationKeyT &prepared_verification_key);
+
+    /// Verify several proofs at once, with a single final exponentiation, by
+    /// checking a random linear combination of their verification equations.
+    /// Returns true if all proofs are valid. If false is returned, at least
+    /// one proof is invalid (and `verify` must be used to find which).
+    static bool verify_batch(
+        const std::vector<libsnark::r1cs_primary_input<libff::Fr<ppT>>>
+            &primary_inputs,
+        const std::vector<ProofT> &proofs,
+        const PreparedVerificationKeyT &prepared_verification_key);
+
     /// Write verification as json
     static std::ostream &verification_key_write_json(
         const VerificationKeyT &, std::ostream &);
@@ -53,6 +108,10 @@ public:
     /// Read proving key as bytes
     static ProvingKeyT proving_key_read_bytes(std::istream &);
 
+    /// Read proving key as bytes (as written by `proving_key_write_bytes`)
+    /// and convert it to affine coordinates.
+    static AffineProvingKeyT affine_proving_key_read_bytes(std::istream &);
+
     /// Write proof as json
     static std::ostream &proof_write_json(
         const ProofT &proof, std::ostream &os);
@@ -6,9 +6,17 @@
 #define __ZETH_SNARKS_GROTH16_GROTH16_SNARK_TCC__
 
 #include "libzeth/core/group_element_utils.hpp"
+#include "libzeth/core/multi_exp.hpp"
 #include "libzeth/core/utils.hpp"
 #include "libzeth/snarks/groth16/groth16_snark.hpp"
 
+#include <libff/algebra/scalar_multiplication/multiexp.hpp>
+#include <libfqfft/evaluation_domain/domains/basic_radix2_domain.hpp>
+#include <libsnark/knowledge_commitment/kc_multiexp.hpp>
+#ifdef MULTICORE
+#include <omp.h>
+#endif
+
 namespace libzeth
 {
 
@@ -26,18 +34,345 @@ typename groth16_snark<ppT>::ProofT groth16_snark<ppT>::generate_proof(
     const libsnark::protoboard<libff::Fr<ppT>> &pb,
     const typename groth16_snark<ppT>::ProvingKeyT &proving_key)
 {
-    libsnark::r1cs_primary_input<libff::Fr<ppT>> primary_input =
-        pb.primary_input();
-    libsnark::r1cs_auxiliary_input<libff::Fr<ppT>> auxiliary_input =
-        pb.auxiliary_input();
+    return generate_proof(
+        proving_key, pb.primary_input(), pb.auxiliary_input());
+}
+
+template<typename ppT>
+typename groth16_snark<ppT>::ProofT groth16_snark<ppT>::generate_proof(
+    const typename groth16_snark<ppT>::ProvingKeyT &proving_key,
+    const libsnark::r1cs_primary_input<libff::Fr<ppT>> &primary_input,
+    const libsnark::r1cs_auxiliary_input<libff::Fr<ppT>> &auxiliary_input)
+{
+    const cancellation_token never_cancelled;
+    return generate_proof(
+        proving_key, primary_input, auxiliary_input, never_cancelled);
+}
+
+namespace
+{
+
+// Compute the coefficients of H = (A * B - C) / Z for the assignment, and the
+// assignment padded with the constant variable 1 (as expected by the A, B and
+// L queries). This follows libsnark::r1cs_gg_ppzksnark_prover, split into
+// phases so that `cancellation` can be checked between them. As in the
+// setup, a power-of-2 domain is used, in case the key came from the MPC.
+template<typename ppT>
+void groth16_compute_h_coefficients(
+    const libsnark::r1cs_constraint_system<libff::Fr<ppT>> &cs,
+    size_t h_query_size,
+    const libsnark::r1cs_primary_input<libff::Fr<ppT>> &primary_input,
+    const libsnark::r1cs_auxiliary_input<libff::Fr<ppT>> &auxiliary_input,
+    const cancellation_token &cancellation,
+    std::vector<libff::Fr<ppT>> &coefficients_for_H,
+    std::vector<libff::Fr<ppT>> &const_padded_assignment)
+{
+    using Fr = libff::Fr<ppT>;
+
+    const size_t num_inputs = cs.num_inputs();
+    const size_t num_constraints = cs.num_constraints();
+    const size_t domain_size = (size_t)1
+                               << libff::log2(num_constraints + num_inputs + 1);
+    if (h_query_size != domain_size - 1) {
+        throw std::invalid_argument("unexpected proving key H_query size");
+    }
+
+    cancellation.check();
+
+    std::vector<Fr> variable_assignment(primary_input);
+    variable_assignment.insert(
+        variable_assignment.end(),
+        auxiliary_input.begin(),
+        auxiliary_input.end());
+
+    // Evaluations of the A and B polynomials on the domain, including the
+    // additional constraints input_i * 0 = 0.
+    std::vector<Fr> aA(domain_size, Fr::zero());
+    std::vector<Fr> aB(domain_size, Fr::zero());
+    aA[num_constraints] = Fr::one();
+    for (size_t i = 0; i < num_inputs; ++i) {
+        aA[num_constraints + i + 1] = variable_assignment[i];
+    }
+#ifdef MULTICORE
+#pragma omp parallel for
+#endif
+    for (size_t i = 0; i < num_constraints; ++i) {
+        aA[i] += cs.constraints[i].a.evaluate(variable_assignment);
+        aB[i] += cs.constraints[i].b.evaluate(variable_assignment);
+    }
+    cancellation.check();
+
+    // Evaluate on a coset of the domain, where Z does not vanish.
+    libfqfft::basic_radix2_domain<Fr> domain(domain_size);
+    const Fr &g = Fr::multiplicative_generator;
+    domain.iFFT(aA);
+    cancellation.check();
+    domain.iFFT(aB);
+    cancellation.check();
+    domain.cosetFFT(aA, g);
+    cancellation.check();
+    domain.cosetFFT(aB, g);
+    cancellation.check();
+
+    // aA is reused to hold the evaluations of H.
+#ifdef MULTICORE
+#pragma omp parallel for
+#endif
+    for (size_t i = 0; i < domain_size; ++i) {
+        aA[i] = aA[i] * aB[i];
+    }
+    std::vector<Fr>().swap(aB);
+
+    std::vector<Fr> aC(domain_size, Fr::zero());
+#ifdef MULTICORE
+#pragma omp parallel for
+#endif
+    for (size_t i = 0; i < num_constraints; ++i) {
+        aC[i] = cs.constraints[i].c.evaluate(variable_assignment);
+    }
+    cancellation.check();
+    domain.iFFT(aC);
+    cancellation.check();
+    domain.cosetFFT(aC, g);
+    cancellation.check();
+
+#ifdef MULTICORE
+#pragma omp parallel for
+#endif
+    for (size_t i = 0; i < domain_size; ++i) {
+        aA[i] = aA[i] - aC[i];
+    }
+    std::vector<Fr>().swap(aC);
+    domain.divide_by_Z_on_coset(aA);
+    domain.icosetFFT(aA, g);
+    coefficients_for_H.swap(aA);
+    cancellation.check();
+
+    const_padded_assignment.assign(1, Fr::one());
+    const_padded_assignment.insert(
+        const_padded_assignment.end(),
+        variable_assignment.begin(),
+        variable_assignment.end());
+}
+
+// Entries of `assignment` at the indices of a sparse query. The indices are
+// checked when the key is attached (see `groth16_mapped_keypair_attach`), so
+// an index beyond the assignment means that the assignment does not match
+// the key.
+template<typename FieldT>
+std::vector<FieldT> groth16_gather_assignment(
+    const std::vector<FieldT> &assignment, const array_view<size_t> &indices)
+{
+    std::vector<FieldT> values;
+    values.reserve(indices.size());
+    for (const size_t index : indices) {
+        if (index >= assignment.size()) {
+            throw std::invalid_argument(
+                "proving key query index out of range of the assignment");
+        }
+        values.push_back(assignment[index]);
+    }
+    return values;
+}
+
+// Build the proof from the multi-exponentiations over the queries of the
+// proving key (of either representation), adding random multiples of delta
+// for zero-knowledge.
+template<typename ppT, typename ProvingKeyT>
+libsnark::r1cs_gg_ppzksnark_proof<ppT> groth16_assemble_proof(
+    const ProvingKeyT &proving_key,
+    const libff::G1<ppT> &evaluation_At,
+    const libff::G1<ppT> &evaluation_Bt_g1,
+    const libff::G2<ppT> &evaluation_Bt_g2,
+    const libff::G1<ppT> &evaluation_Ht,
+    const libff::G1<ppT> &evaluation_Lt)
+{
+    using Fr = libff::Fr<ppT>;
+    using G1 = libff::G1<ppT>;
+    using G2 = libff::G2<ppT>;
+
+    // Random field elements for zero-knowledge.
+    const Fr r = Fr::random_element();
+    const Fr s = Fr::random_element();
+
+    // A = alpha + sum_i(a_i*A_i(t)) + r*delta
+    G1 g1_A = proving_key.alpha_g1 + evaluation_At + r * proving_key.delta_g1;
+
+    // B = beta + sum_i(a_i*B_i(t)) + s*delta
+    const G1 g1_B =
+        proving_key.beta_g1 + evaluation_Bt_g1 + s * proving_key.delta_g1;
+    G2 g2_B = proving_key.beta_g2 + evaluation_Bt_g2 + s * proving_key.delta_g2;
 
-    // Generate proof from public input, auxiliary input and proving key.
-    // For now, force a pow2 domain, in case the key came from the MPC.
-    libsnark::r1cs_gg_ppzksnark_proof<ppT> proof =
-        libsnark::r1cs_gg_ppzksnark_prover(
-            proving_key, primary_input, auxiliary_input, true);
+    // C = sum_i(a_i*((beta*A_i(t) + alpha*B_i(t) + C_i(t)) + H(t)*Z(t))/delta)
+    //     + A*s + r*b - r*s*delta
+    G1 g1_C = evaluation_Ht + evaluation_Lt + s * g1_A + r * g1_B -
+              (r * s) * proving_key.delta_g1;
 
-    return proof;
+    return libsnark::r1cs_gg_ppzksnark_proof<ppT>(
+        std::move(g1_A), std::move(g2_B), std::move(g1_C));
+}
+
+} // namespace
+
+template<typename ppT>
+typename groth16_snark<ppT>::ProofT groth16_snark<ppT>::generate_proof(
+    const typename groth16_snark<ppT>::ProvingKeyT &proving_key,
+    const libsnark::r1cs_primary_input<libff::Fr<ppT>> &primary_input,
+    const libsnark::r1cs_auxiliary_input<libff::Fr<ppT>> &auxiliary_input,
+    const cancellation_token &cancellation)
+{
+    using Fr = libff::Fr<ppT>;
+    using G1 = libff::G1<ppT>;
+    using G2 = libff::G2<ppT>;
+    const libff::multi_exp_method Method = libff::multi_exp_method_BDLO12;
+
+    const size_t num_inputs = proving_key.constraint_system.num_inputs();
+    const size_t num_variables = proving_key.constraint_system.num_variables();
+
+    std::vector<Fr> coefficients_for_H;
+    std::vector<Fr> const_padded_assignment;
+    groth16_compute_h_coefficients<ppT>(
+        proving_key.constraint_system,
+        proving_key.H_query.size(),
+        primary_input,
+        auxiliary_input,
+        cancellation,
+        coefficients_for_H,
+        const_padded_assignment);
+
+#ifdef MULTICORE
+    // To override, set OMP_NUM_THREADS or call omp_set_num_threads()
+    const size_t chunks = omp_get_max_threads();
+#else
+    const size_t chunks = 1;
+#endif
+
+    const G1 evaluation_At =
+        libff::multi_exp_with_mixed_addition<G1, Fr, Method>(
+            proving_key.A_query.begin(),
+            proving_key.A_query.begin() + num_variables + 1,
+            const_padded_assignment.begin(),
+            const_padded_assignment.begin() + num_variables + 1,
+            chunks);
+    cancellation.check();
+
+    const libsnark::knowledge_commitment<G2, G1> evaluation_Bt =
+        libsnark::kc_multi_exp_with_mixed_addition<G2, G1, Fr, Method>(
+            proving_key.B_query,
+            0,
+            num_variables + 1,
+            const_padded_assignment.begin(),
+            const_padded_assignment.begin() + num_variables + 1,
+            chunks);
+    cancellation.check();
+
+    const G1 evaluation_Ht = libff::multi_exp<G1, Fr, Method>(
+        proving_key.H_query.begin(),
+        proving_key.H_query.end(),
+        coefficients_for_H.begin(),
+        coefficients_for_H.begin() + proving_key.H_query.size(),
+        chunks);
+    cancellation.check();
+
+    const G1 evaluation_Lt =
+        libff::multi_exp_with_mixed_addition<G1, Fr, Method>(
+            proving_key.L_query.begin(),
+            proving_key.L_query.end(),
+            const_padded_assignment.begin() + num_inputs + 1,
+            const_padded_assignment.begin() + num_variables + 1,
+            chunks);
+
+    return groth16_assemble_proof<ppT>(
+        proving_key,
+        evaluation_At,
+        evaluation_Bt.h,
+        evaluation_Bt.g,
+        evaluation_Ht,
+        evaluation_Lt);
+}
+
+template<typename ppT>
+typename groth16_snark<ppT>::ProofT groth16_snark<ppT>::generate_proof(
+    const typename groth16_snark<ppT>::AffineProvingKeyT &proving_key,
+    const libsnark::r1cs_primary_input<libff::Fr<ppT>> &primary_input,
+    const libsnark::r1cs_auxiliary_input<libff::Fr<ppT>> &auxiliary_input,
+    const cancellation_token &cancellation)
+{
+    using Fr = libff::Fr<ppT>;
+    using G1 = libff::G1<ppT>;
+    using G2 = libff::G2<ppT>;
+
+    std::vector<Fr> coefficients_for_H;
+    std::vector<Fr> const_padded_assignment;
+    groth16_compute_h_coefficients<ppT>(
+        proving_key.constraint_system,
+        proving_key.H_query.size(),
+        primary_input,
+        auxiliary_input,
+        cancellation,
+        coefficients_for_H,
+        const_padded_assignment);
+
+    // The key points are used in place by the multi-exponentiations, which
+    // accumulate them with (batched) affine and mixed additions. The A, B
+    // and L queries are sparse, and the entries of the assignment are
+    // gathered accordingly.
+    const std::vector<Fr> A_assignment = groth16_gather_assignment(
+        const_padded_assignment, proving_key.A_query_indices);
+    const G1 evaluation_At = multi_exp_affine<Fr, G1>(
+        proving_key.A_query.begin(),
+        proving_key.A_query.begin() + A_assignment.size(),
+        A_assignment.begin(),
+        A_assignment.end(),
+        0,
+        0);
+    cancellation.check();
+
+    const std::vector<Fr> B_assignment = groth16_gather_assignment(
+        const_padded_assignment, proving_key.B_query_indices);
+    const G1 evaluation_Bt_g1 = multi_exp_affine<Fr, G1>(
+        proving_key.B_query_g1.begin(),
+        proving_key.B_query_g1.begin() + B_assignment.size(),
+        B_assignment.begin(),
+        B_assignment.end(),
+        0,
+        0);
+    cancellation.check();
+    const G2 evaluation_Bt_g2 = multi_exp_affine<Fr, G2>(
+        proving_key.B_query_g2.begin(),
+        proving_key.B_query_g2.begin() + B_assignment.size(),
+        B_assignment.begin(),
+        B_assignment.end(),
+        0,
+        0);
+    cancellation.check();
+
+    const G1 evaluation_Ht = multi_exp_affine<Fr, G1>(
+        proving_key.H_query.begin(),
+        proving_key.H_query.end(),
+        coefficients_for_H.begin(),
+        coefficients_for_H.begin() + proving_key.H_query.size(),
+        0,
+        0);
+    cancellation.check();
+
+    const std::vector<Fr> L_assignment = groth16_gather_assignment(
+        const_padded_assignment, proving_key.L_query_indices);
+    const G1 evaluation_Lt = multi_exp_affine<Fr, G1>(
+        proving_key.L_query.begin(),
+        proving_key.L_query.begin() + L_assignment.size(),
+        L_assignment.begin(),
+        L_assignment.end(),
+        0,
+        0);
+
+    return groth16_assemble_proof<ppT>(
+        proving_key,
+        evaluation_At,
+        evaluation_Bt_g1,
+        evaluation_Bt_g2,
+        evaluation_Ht,
+        evaluation_Lt);
 }
 
 template<typename ppT>
@@ -50,6 +385,125 @@ bool groth16_snark<ppT>::verify(
         verification_key, primary_inputs, proof);
 }
 
+template<typename ppT>
+typename groth16_snark<ppT>::PreparedVerificationKeyT groth16_snark<
+    ppT>::prepare_verification_key(const VerificationKeyT &verification_key)
+{
+    return PreparedVerificationKeyT(verification_key);
+}
+
+template<typename ppT>
+bool groth16_snark<ppT>::verify(
+    const libsnark::r1cs_primary_input<libff::Fr<ppT>> &primary_inputs,
+    const groth16_snark<ppT>::ProofT &proof,
+    const groth16_snark<ppT>::PreparedVerificationKeyT
+        &prepared_verification_key)
+{
+    using Fr = libff::Fr<ppT>;
+    using G1 = libff::G1<ppT>;
+
+    if (primary_inputs.size() !=
+            prepared_verification_key.num_primary_inputs() ||
+        !proof.is_well_formed()) {
+        return false;
+    }
+
+    // e(A, B) * e(IC, -gamma) * e(C, -delta) = e(alpha, beta)
+    const G1 IC = prepared_verification_key.ABC_g1
+                      .template accumulate_chunk<Fr>(
+                          primary_inputs.begin(), primary_inputs.end(), 0)
+                      .first;
+    const libff::Fqk<ppT> miller_product =
+        ppT::miller_loop(
+            ppT::precompute_G1(proof.g_A), ppT::precompute_G2(proof.g_B)) *
+        ppT::double_miller_loop(
+            ppT::precompute_G1(IC),
+            prepared_verification_key.minus_gamma_g2_precomp,
+            ppT::precompute_G1(proof.g_C),
+            prepared_verification_key.minus_delta_g2_precomp);
+
+    return ppT::final_exponentiation(miller_product) ==
+           prepared_verification_key.alpha_g1_beta_g2;
+}
+
+template<typename ppT>
+bool groth16_snark<ppT>::verify_batch(
+    const std::vector<libsnark::r1cs_primary_input<libff::Fr<ppT>>>
+        &primary_inputs,
+    const std::vector<groth16_snark<ppT>::ProofT> &proofs,
+    const groth16_snark<ppT>::PreparedVerificationKeyT
+        &prepared_verification_key)
+{
+    using Fr = libff::Fr<ppT>;
+    using G1 = libff::G1<ppT>;
+
+    if (primary_inputs.size() != proofs.size()) {
+        throw std::invalid_argument("inputs and proofs do not match");
+    }
+    if (proofs.empty()) {
+        return true;
+    }
+
+    // Each proof i satisfies:
+    //
+    //   e(A_i, B_i) = e(alpha, beta) * e(IC_i, gamma) * e(C_i, delta)
+    //
+    // where IC_i is the accumulation of the primary inputs. Raising each
+    // equation to a random r_i and taking their product gives:
+    //
+    //   prod_i e(r_i * A_i, B_i) *
+    //     e(sum_i r_i * IC_i, -gamma) * e(sum_i r_i * C_i, -delta)
+    //       = e(alpha, beta)^(sum_i r_i)
+    //
+    // which is checked with one Miller loop per proof, plus two, and a single
+    // final exponentiation. If any proof is invalid, the check passes with
+    // negligible probability.
+    const libsnark::accumulation_vector<G1> &ABC_g1 =
+        prepared_verification_key.ABC_g1;
+    const size_t num_inputs = prepared_verification_key.num_primary_inputs();
+    Fr r_sum = Fr::zero();
+    std::vector<Fr> input_coefficients(num_inputs, Fr::zero());
+    G1 sum_r_C = G1::zero();
+    libff::Fqk<ppT> miller_product = libff::Fqk<ppT>::one();
+    for (size_t i = 0; i < proofs.size(); ++i) {
+        const ProofT &proof = proofs[i];
+        const libsnark::r1cs_primary_input<Fr> &inputs = primary_inputs[i];
+        if (inputs.size() != num_inputs || !proof.is_well_formed()) {
+            return false;
+        }
+
+        const Fr r = Fr::random_element();
+        r_sum += r;
+        for (size_t j = 0; j < num_inputs; ++j) {
+            input_coefficients[j] += r * inputs[j];
+        }
+        sum_r_C = sum_r_C + r * proof.g_C;
+        miller_product = miller_product *
+                         ppT::miller_loop(
+                             ppT::precompute_G1(r * proof.g_A),
+                             ppT::precompute_G2(proof.g_B));
+    }
+
+    // sum_i r_i * IC_i = (sum_i r_i) * ABC_0 + sum_j (sum_i r_i x_ij) * ABC_j
+    const G1 sum_r_IC =
+        ABC_g1
+            .template accumulate_chunk<Fr>(
+                input_coefficients.begin(), input_coefficients.end(), 0)
+            .first +
+        (r_sum - Fr::one()) * ABC_g1.first;
+
+    miller_product = miller_product *
+                     ppT::double_miller_loop(
+                         ppT::precompute_G1(sum_r_IC),
+                         prepared_verification_key.minus_gamma_g2_precomp,
+                         ppT::precompute_G1(sum_r_C),
+                         prepared_verification_key.minus_delta_g2_precomp);
+
+    const libff::GT<ppT> result = ppT::final_exponentiation(miller_product);
+    return result ==
+           (prepared_verification_key.alpha_g1_beta_g2 ^ r_sum.as_bigint());
+}
+
 template<typename ppT>
 std::ostream &groth16_snark<ppT>::verification_key_write_json(
     const VerificationKeyT &vk, std::ostream &os)
@@ -113,6 +567,13 @@ typename groth16_snark<ppT>::ProvingKeyT groth16_snark<
     return pk;
 }
 
+template<typename ppT>
+typename groth16_snark<ppT>::AffineProvingKeyT groth16_snark<
+    ppT>::affine_proving_key_read_bytes(std::istream &is)
+{
+    return AffineProvingKeyT(proving_key_read_bytes(is));
+}
+
 template<typename ppT>
 std::ostream &groth16_snark<ppT>::keypair_write_bytes(
     std::ostream &os, const typename groth16_snark<ppT>::KeypairT &keypair)
@@ -5,6 +5,8 @@
 #ifndef __ZETH_SNARKS_PGHR13_PGHR13_SNARK_HPP__
 #define __ZETH_SNARKS_PGHR13_PGHR13_SNARK_HPP__
 
+#include "libzeth/core/cancellation.hpp"
+
 #include <boost/filesystem.hpp>
 #include <libsnark/gadgetlib1/protoboard.hpp>
 #include <libsnark/zk_proof_systems/ppzksnark/r1cs_ppzksnark/r1cs_ppzksnark.hpp>
@@ -19,6 +21,8 @@ public:
     typedef libsnark::r1cs_ppzksnark_verification_key<ppT> VerificationKeyT;
     typedef libsnark::r1cs_ppzksnark_keypair<ppT> KeypairT;
     typedef libsnark::r1cs_ppzksnark_proof<ppT> ProofT;
+    typedef libsnark::r1cs_ppzksnark_processed_verification_key<ppT>
+        PreparedVerificationKeyT;
 
     /// Run the trusted setup and return the keypair for the circuit
     static KeypairT generate_setup(
@@ -29,12 +33,47 @@ public:
         const libsnark::protoboard<libff::Fr<ppT>> &pb,
         const ProvingKeyT &proving_key);
 
+    /// Generate the proof from an assignment which has already been extracted
+    /// from a protoboard.
+    static ProofT generate_proof(
+        const ProvingKeyT &proving_key,
+        const libsnark::r1cs_primary_input<libff::Fr<ppT>> &primary_input,
+        const libsnark::r1cs_auxiliary_input<libff::Fr<ppT>> &auxiliary_input);
+
+    /// Generate the proof from an assignment. The libsnark prover cannot be
+    /// interrupted, so `cancellation` is only checked before and after
+    /// generating the proof (throwing `operation_cancelled`).
+    static ProofT generate_proof(
+        const ProvingKeyT &proving_key,
+        const libsnark::r1cs_primary_input<libff::Fr<ppT>> &primary_input,
+        const libsnark::r1cs_auxiliary_input<libff::Fr<ppT>> &auxiliary_input,
+        const cancellation_token &cancellation);
+
     /// Verify proof
     static bool verify(
         const libsnark::r1cs_primary_input<libff::Fr<ppT>> &primary_inputs,
         const ProofT &proof,
         const VerificationKeyT &verification_key);
 
+    /// Precompute the values used by the verifier, so that they can be
+    /// reused across calls to `verify` and `verify_batch`.
+    static PreparedVerificationKeyT prepare_verification_key(
+        const VerificationKeyT &verification_key);
+
+    /// Verify proof, using a prepared verification key
+    static bool verify(
+        const libsnark::r1cs_primary_input<libff::Fr<ppT>> &primary_inputs,
+        const ProofT &proof,
+        const PreparedVerificationKeyT &prepared_verification_key);
+
+    /// Verify several proofs. Returns true if all proofs are valid. (No
+    /// batching is implemented for PGHR13: each proof is verified in turn.)
+    static bool verify_batch(
+        const std::vector<libsnark::r1cs_primary_input<libff::Fr<ppT>>>
+            &primary_inputs,
+        const std::vector<ProofT> &proofs,
+        const PreparedVerificationKeyT &prepared_verification_key);
+
     /// Write verification as json
     static std::ostream &verification_key_write_json(
         const VerificationKeyT &, std::ostream &);
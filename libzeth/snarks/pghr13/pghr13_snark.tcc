@@ -27,11 +27,16 @@ typename pghr13_snark<ppT>::ProofT pghr13_snark<ppT>::generate_proof(
     // See:
     // https://github.com/scipr-lab/libsnark/blob/92a80f74727091fdc40e6021dc42e9f6b67d5176/libsnark/relations/constraint_satisfaction_problems/r1cs/r1cs.hpp#L81
     // For the definition of r1cs_primary_input and r1cs_auxiliary_input
-    libsnark::r1cs_primary_input<libff::Fr<ppT>> primary_input =
-        pb.primary_input();
-    libsnark::r1cs_auxiliary_input<libff::Fr<ppT>> auxiliary_input =
-        pb.auxiliary_input();
+    return generate_proof(
+        proving_key, pb.primary_input(), pb.auxiliary_input());
+}
 
+template<typename ppT>
+typename pghr13_snark<ppT>::ProofT pghr13_snark<ppT>::generate_proof(
+    const pghr13_snark<ppT>::ProvingKeyT &proving_key,
+    const libsnark::r1cs_primary_input<libff::Fr<ppT>> &primary_input,
+    const libsnark::r1cs_auxiliary_input<libff::Fr<ppT>> &auxiliary_input)
+{
     // Generate proof from public input, auxiliary input (private/secret data),
     // and proving key
     ProofT proof = libsnark::r1cs_ppzksnark_prover(
@@ -40,6 +45,19 @@ typename pghr13_snark<ppT>::ProofT pghr13_snark<ppT>::generate_proof(
     return proof;
 }
 
+template<typename ppT>
+typename pghr13_snark<ppT>::ProofT pghr13_snark<ppT>::generate_proof(
+    const pghr13_snark<ppT>::ProvingKeyT &proving_key,
+    const libsnark::r1cs_primary_input<libff::Fr<ppT>> &primary_input,
+    const libsnark::r1cs_auxiliary_input<libff::Fr<ppT>> &auxiliary_input,
+    const cancellation_token &cancellation)
+{
+    cancellation.check();
+    ProofT proof = generate_proof(proving_key, primary_input, auxiliary_input);
+    cancellation.check();
+    return proof;
+}
+
 template<typename ppT>
 bool pghr13_snark<ppT>::verify(
     const libsnark::r1cs_primary_input<libff::Fr<ppT>> &primary_inputs,
@@ -50,6 +68,44 @@ bool pghr13_snark<ppT>::verify(
         verification_key, primary_inputs, proof);
 }
 
+template<typename ppT>
+typename pghr13_snark<ppT>::PreparedVerificationKeyT pghr13_snark<
+    ppT>::prepare_verification_key(const VerificationKeyT &verification_key)
+{
+    return libsnark::r1cs_ppzksnark_verifier_process_vk<ppT>(
+        verification_key);
+}
+
+template<typename ppT>
+bool pghr13_snark<ppT>::verify(
+    const libsnark::r1cs_primary_input<libff::Fr<ppT>> &primary_inputs,
+    const pghr13_snark<ppT>::ProofT &proof,
+    const pghr13_snark<ppT>::PreparedVerificationKeyT
+        &prepared_verification_key)
+{
+    return libsnark::r1cs_ppzksnark_online_verifier_strong_IC<ppT>(
+        prepared_verification_key, primary_inputs, proof);
+}
+
+template<typename ppT>
+bool pghr13_snark<ppT>::verify_batch(
+    const std::vector<libsnark::r1cs_primary_input<libff::Fr<ppT>>>
+        &primary_inputs,
+    const std::vector<pghr13_snark<ppT>::ProofT> &proofs,
+    const pghr13_snark<ppT>::PreparedVerificationKeyT
+        &prepared_verification_key)
+{
+    if (primary_inputs.size() != proofs.size()) {
+        throw std::invalid_argument("inputs and proofs do not match");
+    }
+    for (size_t i = 0; i < proofs.size(); ++i) {
+        if (!verify(primary_inputs[i], proofs[i], prepared_verification_key)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 template<typename ppT>
 std::ostream &pghr13_snark<ppT>::verification_key_write_json(
     const pghr13_snark<ppT>::VerificationKeyT &vk, std::ostream &os)
@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: LGPL-3.0+
 
 #include "libzeth/circuits/blake2s/blake2s.hpp"
+#include "libzeth/circuits/blake2s/blake2s_native.hpp"
 #include "libzeth/circuits/blake2s/g_primitive.hpp"
 #include "libzeth/circuits/circuit_types.hpp"
 #include "libzeth/circuits/circuit_utils.hpp"
@@ -216,6 +217,7 @@ TEST(TestBlake2sComp, TestTrue)
     BLAKE2s_256_comp<FieldT> BLAKE2sC_gadget(pb, h, input, output);
     BLAKE2sC_gadget.generate_r1cs_constraints();
     BLAKE2sC_gadget.generate_r1cs_witness(11);
+    ASSERT_TRUE(pb.is_satisfied());
 
     // blake2s(b"hello world")
     libsnark::pb_variable_array<FieldT> expected =
@@ -295,6 +297,7 @@ TEST(TestBlake2s, TestTrue)
     BLAKE2s_256<FieldT> blake2s_gadget(pb, input, output);
     blake2s_gadget.generate_r1cs_constraints();
     blake2s_gadget.generate_r1cs_witness();
+    ASSERT_TRUE(pb.is_satisfied());
 
     // blake2s(b"hello world")
     libsnark::pb_variable_array<FieldT> expected =
@@ -491,6 +494,7 @@ TEST(TestBlake2s, TestTrue2)
     BLAKE2s_256<FieldT> blake2s_gadget(pb, input, output);
     blake2s_gadget.generate_r1cs_constraints();
     blake2s_gadget.generate_r1cs_witness();
+    ASSERT_TRUE(pb.is_satisfied());
 
     // blake2s(b"zeth")
     bits256 expected = bits256_from_hex(
@@ -499,6 +503,30 @@ TEST(TestBlake2s, TestTrue2)
     ASSERT_EQ(bits256_to_vector(expected), output.bits.get_bits(pb));
 }
 
+// The native implementation must agree with the gadgets (see the test
+// vectors above), for single and multiple blocks.
+TEST(TestBlake2sNative, TestTrue)
+{
+    // blake2s(b"hello world")
+    const libff::bit_vector hello_world =
+        bit_vector_from_hex("68656c6c6f20776f726c64");
+    ASSERT_EQ(
+        bit_vector_from_hex("9aec6806794561107e594b1f6a8a6b0c92a0cba9acf5e5e93c"
+                            "ca06f781813b0b"),
+        BLAKE2s_256_native::get_hash(hello_world));
+
+    // Same (two block) input as TestBlake2s.TestTrue2
+    const libff::bit_vector two_blocks = bit_vector_from_hex(
+        "7a6574687a6574687a6574687a6574687a6574687a6574687a6574687a657468"
+        "7a6574687a6574687a6574687a6574687a6574687a6574687a6574687a657468"
+        "7a6574687a6574687a6574687a6574687a6574687a6574687a6574687a657468"
+        "7a6574687a6574687a6574687a6574687a6574687a6574687a6574687a657468");
+    ASSERT_EQ(
+        bits256_to_vector(bits256_from_hex(
+            "b5f199b422df36c99363725d886e64c07ffd8852063adbbfbb86f43716ffab0e")),
+        BLAKE2s_256_native::get_hash(two_blocks));
+}
+
 } // namespace
 
 int main(int argc, char **argv)
@@ -0,0 +1,152 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#include "libzeth/circuits/blake2s/blake2s.hpp"
+#include "libzeth/circuits/circuit_types.hpp"
+#include "libzeth/circuits/joinsplit.tcc"
+#include "libzeth/core/bits.hpp"
+#include "libzeth/core/merkle_tree_field.hpp"
+#include "libzeth/core/note.hpp"
+#include "libzeth/core/utils.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace libzeth;
+
+typedef libzeth::ppT ppT;
+
+// Should be alt_bn128 in the CMakeLists.txt
+typedef libff::Fr<ppT> FieldT;
+
+// We use our hash functions to do the tests
+typedef BLAKE2s_256<FieldT> HashT;
+typedef MiMC_mp_gadget<FieldT> HashTreeT;
+static const size_t TreeDepth = 4;
+
+using joinsplit_gadget_2_2 =
+    joinsplit_gadget<FieldT, HashT, HashTreeT, 2, 2, TreeDepth>;
+
+namespace
+{
+
+// Generate the witness of a 2-2 joinsplit (spending a note of value
+// 0x2F0000000000000F and a zero-valued note), either serially or in parallel.
+std::vector<FieldT> generate_joinsplit_assignment(
+    bool parallel, bool &is_satisfied)
+{
+    libsnark::protoboard<FieldT> pb;
+    joinsplit_gadget_2_2 joinsplit_g(pb);
+    joinsplit_g.generate_r1cs_constraints();
+
+    const bits256 trap_r_bits256 = bits256_from_hex(
+        "0F000000000000FF00000000000000FF00000000000000FF00000000000000FF");
+    const bits256 a_sk_bits256 = bits256_from_hex(
+        "FF0000000000000000000000000000000000000000000000000000000000000F");
+    const bits256 a_pk_bits256 = bits256_from_hex(
+        "f172d7299ac8ac974ea59413e4a87691826df038ba24a2b52d5c5d15c2cc8c49");
+    const bits256 nf_bits256 = bits256_from_hex(
+        "ff2f41920346251f6e7c67062149f98bc90c915d3d3020927ca01deab5da0fd7");
+    const zeth_note note_input(
+        a_pk_bits256,
+        bits64_from_hex("2F0000000000000F"),
+        bits256_from_hex(
+            "FFFF000000000000000000000000000000000000000000000000000000009009"),
+        trap_r_bits256);
+    const zeth_note note_dummy_input(
+        a_pk_bits256,
+        bits64_from_hex("0000000000000000"),
+        bits256_from_hex(
+            "AAAA00000000000000000000000000000000000000000000000000000000EEEE"),
+        trap_r_bits256);
+
+    // Insert the commitment of the (non-zero) input note in a tree
+    const size_t address = 1;
+    libff::bit_vector address_bits;
+    for (size_t i = 0; i < TreeDepth; ++i) {
+        address_bits.push_back((address >> i) & 0x1);
+    }
+    merkle_tree_field<FieldT, HashTreeT> tree(TreeDepth);
+    tree.set_value(
+        address,
+        FieldT("1042337073265819561558789652115525918926201435246168644097060"
+               "09242461667751082"));
+    const FieldT root = tree.get_root();
+    const std::vector<FieldT> path = tree.get_path(address);
+
+    const std::array<joinsplit_input<FieldT, TreeDepth>, 2> inputs{
+        {joinsplit_input<FieldT, TreeDepth>(
+             path,
+             bits_addr_from_vector<TreeDepth>(address_bits),
+             note_input,
+             a_sk_bits256,
+             nf_bits256),
+         joinsplit_input<FieldT, TreeDepth>(
+             path,
+             bits_addr_from_vector<TreeDepth>(address_bits),
+             note_dummy_input,
+             a_sk_bits256,
+             nf_bits256)}};
+
+    const bits256 a_pk_out_bits256 = bits256_from_hex(
+        "7777f753bfe21ba2219ced74875b8dbd8c114c3c79d7e41306dd82118de1895b");
+    const bits256 trap_r_out_bits256 = bits256_from_hex(
+        "11000000000000990000000000000099000000000000007700000000000000FF");
+    const std::array<zeth_note, 2> outputs{
+        {zeth_note(
+             a_pk_out_bits256,
+             bits64_from_hex("1800000000000008"),
+             bits256(),
+             trap_r_out_bits256),
+         zeth_note(
+             a_pk_out_bits256,
+             bits64_from_hex("0000000000000000"),
+             bits256(),
+             trap_r_out_bits256)}};
+
+    joinsplit_g.generate_r1cs_witness(
+        {{root, root}},
+        inputs,
+        outputs,
+        bits64_from_hex("0000000000000000"),
+        bits64_from_hex("1700000000000007"),
+        bits256_from_hex(
+            "6838aac4d8247655715d3dfb9b32573da2b7d3360ba89ccdaaa7923bb24c99f7"),
+        bits256_from_hex(
+            "403794c0e20e3bf36b820d8f7aef5505e5d1c7ac265d5efbcc3030a74a3f701b"),
+        parallel);
+
+    is_satisfied = pb.is_satisfied();
+    return pb.full_variable_assignment();
+}
+
+TEST(TestJoinsplitCircuit, ParallelWitnessMatchesSerialWitness)
+{
+    bool serial_satisfied = false;
+    const std::vector<FieldT> serial_assignment =
+        generate_joinsplit_assignment(false, serial_satisfied);
+    ASSERT_TRUE(serial_satisfied);
+
+    bool parallel_satisfied = false;
+    const std::vector<FieldT> parallel_assignment =
+        generate_joinsplit_assignment(true, parallel_satisfied);
+    ASSERT_TRUE(parallel_satisfied);
+
+    ASSERT_EQ(serial_assignment.size(), parallel_assignment.size());
+    for (size_t i = 0; i < serial_assignment.size(); ++i) {
+        ASSERT_EQ(serial_assignment[i], parallel_assignment[i])
+            << "variable " << i;
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    // /!\ WARNING: Do once for all tests. Do not
+    // forget to do this !!!!
+    ppT::init_public_params();
+
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -212,6 +212,59 @@ TEST(TestMiMCMp, TestFalse)
     ASSERT_FALSE(unexpected_out == pb.val(mimc_mp_gadget.result()));
 }
 
+TEST(TestMiMCNative, PermutationMatchesGadget)
+{
+    // Known value (see TestMiMCPerm)
+    const FieldT x("3703141493535563179657531719960160174296085208671919316200"
+                   "479060314459804651");
+    const FieldT k("1568395149631190174933950911896067630329022481212975289070"
+                   "6581988986633412003");
+    const FieldT expected_out("19299072331547804977312469120569834811561748095"
+                              "378968014959488920239255590840");
+    ASSERT_EQ(expected_out, MiMCe7_permutation<FieldT>::permute(x, k));
+
+    for (size_t i = 0; i < 8; ++i) {
+        libsnark::protoboard<FieldT> pb;
+        libsnark::pb_variable<FieldT> in_x;
+        libsnark::pb_variable<FieldT> in_k;
+        in_x.allocate(pb, "x");
+        in_k.allocate(pb, "k");
+        pb.val(in_x) = FieldT::random_element();
+        pb.val(in_k) = FieldT::random_element();
+
+        MiMCe7_permutation_gadget<FieldT> mimc_gadget(
+            pb, in_x, in_k, "mimc_gadget");
+        mimc_gadget.generate_r1cs_witness();
+
+        ASSERT_EQ(
+            pb.val(mimc_gadget.result()),
+            MiMCe7_permutation<FieldT>::permute(pb.val(in_x), pb.val(in_k)));
+    }
+}
+
+TEST(TestMiMCNative, HashMatchesGadget)
+{
+    for (size_t i = 0; i < 8; ++i) {
+        libsnark::protoboard<FieldT> pb;
+        libsnark::pb_variable<FieldT> x;
+        libsnark::pb_variable<FieldT> y;
+        x.allocate(pb, "x");
+        y.allocate(pb, "y");
+        pb.val(x) = FieldT::random_element();
+        pb.val(y) = FieldT::random_element();
+
+        MiMC_mp_gadget<FieldT> mimc_mp_gadget(pb, x, y, "gadget");
+        mimc_mp_gadget.generate_r1cs_witness();
+
+        ASSERT_EQ(
+            pb.val(mimc_mp_gadget.result()),
+            MiMC_mp<FieldT>::get_hash(pb.val(x), pb.val(y)));
+        ASSERT_EQ(
+            pb.val(mimc_mp_gadget.result()),
+            MiMC_mp_gadget<FieldT>::get_hash(pb.val(x), pb.val(y)));
+    }
+}
+
 } // namespace
 
 int main(int argc, char **argv)
@@ -1,7 +1,10 @@
 // Copyright (c) 2019 HarryR
 // License: LGPL-3.0+
 #include "libzeth/circuits/circuit_types.hpp"
+#include "libzeth/circuits/merkle_tree/merkle_path_authenticator.hpp"
 #include "libzeth/circuits/poseidon/poseidon.hpp"
+#include "libzeth/circuits/poseidon/poseidon_tree_hash.hpp"
+#include "libzeth/core/merkle_tree_field.hpp"
 
 #include "gtest/gtest.h"
 
@@ -53,6 +56,126 @@ namespace
     FieldT expected_out = FieldT("12242166908188651009877250812424843524687801523336557272219921456462821518061");
     ASSERT_TRUE(expected_out == pb.val(the_gadget.result()));
 }
+
+TEST(TestPoseidon, NativeMatchesGadget)
+{
+    const FieldT expected_out = FieldT("12242166908188651009877250812424843524687801523336557272219921456462821518061");
+    ASSERT_EQ(expected_out, Poseidon128_native<FieldT>::get_hash(FieldT("1"), FieldT("2")));
+
+    for (size_t i = 0; i < 8; ++i) {
+        libsnark::protoboard<FieldT> pb;
+        libsnark::pb_variable_array<FieldT> x;
+        x.allocate(pb, 2, "x");
+        pb.val(x[0]) = FieldT::random_element();
+        pb.val(x[1]) = FieldT::random_element();
+
+        Poseidon128<2,1,FieldT> the_gadget(pb, x[0], x[1], "gadget");
+        the_gadget.generate_r1cs_witness();
+
+        ASSERT_EQ(
+            pb.val(the_gadget.result()),
+            Poseidon128_native<FieldT>::get_hash(pb.val(x[0]), pb.val(x[1])));
+    }
+}
+
+// Size of the Poseidon128 circuit: 3 constraints and variables per S-box
+// (8 full rounds of 6 S-boxes, 57 partial rounds of 1 S-box), plus the output.
+// The inputs must not be duplicated, and the linear combinations (non-zero
+// entries of the constraint system) must not grow.
+TEST(TestPoseidon, CircuitSize)
+{
+    libsnark::protoboard<FieldT> pb;
+    libsnark::pb_variable<FieldT> x;
+    libsnark::pb_variable<FieldT> y;
+    x.allocate(pb, "x");
+    y.allocate(pb, "y");
+
+    Poseidon128<2, 1, FieldT> the_gadget(pb, x, y, "gadget");
+    the_gadget.generate_r1cs_constraints();
+
+    const size_t num_sboxes = 8 * 6 + 57 * 1;
+    ASSERT_EQ(3 * num_sboxes + 1, pb.num_constraints());
+    ASSERT_EQ(2 + 3 * num_sboxes + 1, pb.num_variables());
+
+    size_t num_terms = 0;
+    for (const libsnark::r1cs_constraint<FieldT> &constraint :
+         pb.get_constraint_system().constraints) {
+        num_terms += constraint.a.terms.size() + constraint.b.terms.size() +
+                     constraint.c.terms.size();
+    }
+    ASSERT_EQ(8555U, num_terms);
+
+    pb.val(x) = FieldT::random_element();
+    pb.val(y) = FieldT::random_element();
+    the_gadget.generate_r1cs_witness();
+    ASSERT_TRUE(pb.is_satisfied());
+    ASSERT_EQ(
+        Poseidon128_native<FieldT>::get_hash(pb.val(x), pb.val(y)),
+        pb.val(the_gadget.result()));
+}
+
+// The generated tables (poseidon_constants_alt_bn128.hpp) must match the
+// constants derived at run time.
+TEST(TestPoseidon, PrecomputedConstantsMatchDerivation)
+{
+    const PoseidonConstants<FieldT> &constants =
+        poseidon_params<6, 8, 57, FieldT>();
+    const PoseidonConstants<FieldT> derived =
+        poseidon_derive_params<6, 8, 57, FieldT>();
+    ASSERT_EQ(derived.C, constants.C);
+    ASSERT_EQ(derived.M, constants.M);
+}
+
+// Poseidon_tree_hash_gadget used as the HashTreeT of the Merkle tree gadgets,
+// against a tree computed natively.
+TEST(TestPoseidon, TreeHashAuthenticatesMerklePath)
+{
+    using HashTreeT = Poseidon_tree_hash_gadget<FieldT>;
+    const size_t tree_depth = 4;
+    const size_t address = 5;
+
+    merkle_tree_field<FieldT, HashTreeT> tree(tree_depth);
+    tree.set_value(2, FieldT::random_element());
+    tree.set_value(address, FieldT::random_element());
+    const std::vector<FieldT> path_values = tree.get_path(address);
+
+    libsnark::protoboard<FieldT> pb;
+    libsnark::pb_variable_array<FieldT> address_bits;
+    address_bits.allocate(pb, tree_depth, "address_bits");
+    libsnark::pb_variable_array<FieldT> path;
+    path.allocate(pb, tree_depth, "path");
+    for (size_t i = 0; i < tree_depth; ++i) {
+        pb.val(address_bits[i]) = FieldT((address >> i) & 1);
+        pb.val(path[i]) = path_values[i];
+    }
+
+    libsnark::pb_variable<FieldT> leaf;
+    leaf.allocate(pb, "leaf");
+    pb.val(leaf) = tree.get_value(address);
+
+    libsnark::pb_variable<FieldT> expected_root;
+    expected_root.allocate(pb, "expected_root");
+    pb.val(expected_root) = tree.get_root();
+
+    libsnark::pb_variable<FieldT> enforce_bit;
+    enforce_bit.allocate(pb, "enforce_bit");
+    pb.val(enforce_bit) = FieldT::one();
+
+    merkle_path_authenticator<FieldT, HashTreeT> auth(
+        pb,
+        tree_depth,
+        address_bits,
+        leaf,
+        expected_root,
+        path,
+        enforce_bit,
+        "authenticator");
+    auth.generate_r1cs_constraints();
+    auth.generate_r1cs_witness();
+
+    ASSERT_TRUE(auth.is_valid());
+    ASSERT_TRUE(pb.is_satisfied());
+}
 }
 int main(int argc, char **argv)
 {
@@ -0,0 +1,126 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#include "libzeth/circuits/circuit_types.hpp"
+#include "libzeth/core/append_merkle_tree_field.hpp"
+#include "libzeth/core/merkle_tree_field.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace libzeth;
+
+using tree_hash = MiMC_mp_gadget<FieldT>;
+using append_tree = append_merkle_tree_field<FieldT, tree_hash>;
+using reference_tree = merkle_tree_field<FieldT, tree_hash>;
+
+namespace
+{
+
+const size_t test_depth = 6;
+
+std::vector<FieldT> random_leaves(size_t num_leaves)
+{
+    std::vector<FieldT> leaves;
+    leaves.reserve(num_leaves);
+    for (size_t i = 0; i < num_leaves; ++i) {
+        leaves.push_back(FieldT::random_element());
+    }
+    return leaves;
+}
+
+void assert_trees_equal(const reference_tree &expected, const append_tree &tree)
+{
+    ASSERT_EQ(expected.get_root(), tree.get_root());
+    for (size_t address = 0; address < tree.capacity(); ++address) {
+        ASSERT_EQ(expected.get_value(address), tree.get_value(address));
+        ASSERT_EQ(expected.get_path(address), tree.get_path(address));
+    }
+}
+
+TEST(AppendMerkleTreeFieldTest, Empty)
+{
+    const reference_tree expected(test_depth);
+    const append_tree tree(test_depth);
+    ASSERT_EQ(0u, tree.num_leaves());
+    assert_trees_equal(expected, tree);
+}
+
+TEST(AppendMerkleTreeFieldTest, Append)
+{
+    reference_tree expected(test_depth);
+    append_tree tree(test_depth);
+    const std::vector<FieldT> leaves = random_leaves(13);
+    for (size_t i = 0; i < leaves.size(); ++i) {
+        expected.set_value(i, leaves[i]);
+        tree.append(leaves[i]);
+        ASSERT_EQ(expected.get_root(), tree.get_root());
+    }
+    assert_trees_equal(expected, tree);
+}
+
+TEST(AppendMerkleTreeFieldTest, AppendBatch)
+{
+    reference_tree expected(test_depth);
+    append_tree tree(test_depth);
+
+    // Batches of different sizes, starting at both odd and even addresses,
+    // up to a full tree.
+    const size_t batch_sizes[] = {1, 4, 7, 0, 16, 36};
+    for (const size_t batch_size : batch_sizes) {
+        const std::vector<FieldT> leaves = random_leaves(batch_size);
+        for (size_t i = 0; i < batch_size; ++i) {
+            expected.set_value(tree.num_leaves() + i, leaves[i]);
+        }
+        tree.append_batch(leaves);
+        assert_trees_equal(expected, tree);
+    }
+
+    ASSERT_EQ(tree.capacity(), tree.num_leaves());
+    ASSERT_THROW(tree.append(FieldT::one()), std::invalid_argument);
+}
+
+TEST(AppendMerkleTreeFieldTest, AppendBatchOverflow)
+{
+    append_tree tree(2);
+    tree.append_batch(random_leaves(3));
+    const FieldT root = tree.get_root();
+    ASSERT_THROW(tree.append_batch(random_leaves(2)), std::invalid_argument);
+    ASSERT_EQ(3u, tree.num_leaves());
+    ASSERT_EQ(root, tree.get_root());
+}
+
+TEST(AppendMerkleTreeFieldTest, BulkBuild)
+{
+    // Large enough for the parallel path to be used on the lower layers.
+    const size_t depth = 9;
+    const std::vector<FieldT> leaves = random_leaves(300);
+
+    append_tree incremental(depth);
+    for (const FieldT &leaf : leaves) {
+        incremental.append(leaf);
+    }
+
+    const append_tree bulk(depth, leaves);
+    ASSERT_EQ(incremental.get_root(), bulk.get_root());
+    for (size_t layer = 0; layer <= depth; ++layer) {
+        ASSERT_EQ(incremental.get_layer(layer), bulk.get_layer(layer));
+    }
+
+    // The vector constructor of merkle_tree_field uses the bulk build.
+    const reference_tree from_vector(depth, leaves);
+    ASSERT_EQ(bulk.get_root(), from_vector.get_root());
+    for (size_t address = 0; address < bulk.capacity(); address += 7) {
+        ASSERT_EQ(bulk.get_value(address), from_vector.get_value(address));
+        ASSERT_EQ(bulk.get_path(address), from_vector.get_path(address));
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    ppT::init_public_params();
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
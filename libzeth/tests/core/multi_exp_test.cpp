@@ -0,0 +1,150 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#include "libzeth/circuits/circuit_types.hpp"
+#include "libzeth/core/multi_exp.hpp"
+
+#include <gtest/gtest.h>
+
+using ppT = libzeth::ppT;
+using Fr = libff::Fr<ppT>;
+using G1 = libff::G1<ppT>;
+using G2 = libff::G2<ppT>;
+
+namespace
+{
+
+// Generate `n` points, including the point at infinity, repeated points
+// (exercising doubling in the buckets), inverses of previous points, and
+// points which are not normalized.
+template<typename GroupT> std::vector<GroupT> test_points(size_t n)
+{
+    std::vector<GroupT> points;
+    points.reserve(n);
+    GroupT p = GroupT::random_element();
+    const GroupT step = GroupT::random_element();
+    for (size_t i = 0; i < n; ++i) {
+        if (i % 17 == 3) {
+            points.push_back(GroupT::zero());
+        } else if (i % 11 == 5) {
+            points.push_back(points[i / 2]);
+        } else if (i % 13 == 7) {
+            points.push_back(-points[i / 3]);
+        } else {
+            p = p + step;
+            points.push_back(p);
+            if (i % 2 == 0) {
+                points.back().to_affine_coordinates();
+            }
+        }
+    }
+    return points;
+}
+
+// Generate `n` scalars, including 0, -1 (all windows non-zero) and repeated
+// scalars.
+std::vector<Fr> test_scalars(size_t n)
+{
+    std::vector<Fr> scalars;
+    scalars.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        if (i % 7 == 1) {
+            scalars.push_back(Fr::zero());
+        } else if (i % 19 == 2) {
+            scalars.push_back(-Fr::one());
+        } else if (i % 5 == 4) {
+            scalars.push_back(scalars[i / 2]);
+        } else {
+            scalars.push_back(Fr::random_element());
+        }
+    }
+    return scalars;
+}
+
+template<typename GroupT>
+GroupT naive_multi_exp(
+    const std::vector<GroupT> &points, const std::vector<Fr> &scalars)
+{
+    GroupT result = GroupT::zero();
+    for (size_t i = 0; i < points.size(); ++i) {
+        result = result + scalars[i] * points[i];
+    }
+    return result;
+}
+
+template<typename GroupT> void test_multi_exp_pippenger(size_t n)
+{
+    const std::vector<GroupT> points = test_points<GroupT>(n);
+    const std::vector<Fr> scalars = test_scalars(n);
+    const GroupT expected = naive_multi_exp(points, scalars);
+
+    ASSERT_EQ(
+        expected,
+        libzeth::multi_exp<Fr, GroupT>(
+            points.begin(), points.end(), scalars.begin(), scalars.end()))
+        << "n=" << std::to_string(n);
+
+    for (const size_t num_threads : {1, 3}) {
+        for (const size_t window_bits : {1, 4, 13}) {
+            ASSERT_EQ(
+                expected,
+                libzeth::multi_exp_pippenger<Fr, GroupT>(
+                    points.begin(),
+                    points.end(),
+                    scalars.begin(),
+                    scalars.end(),
+                    num_threads,
+                    window_bits))
+                << "n=" << std::to_string(n)
+                << ", num_threads=" << std::to_string(num_threads)
+                << ", window_bits=" << std::to_string(window_bits);
+        }
+    }
+}
+
+TEST(MultiExpTest, MultiExpPippengerG1)
+{
+    for (const size_t n : {0, 1, 7, 8, 100, 1500, 5000}) {
+        test_multi_exp_pippenger<G1>(n);
+    }
+}
+
+TEST(MultiExpTest, MultiExpPippengerG2)
+{
+    for (const size_t n : {0, 5, 100, 1500}) {
+        test_multi_exp_pippenger<G2>(n);
+    }
+}
+
+TEST(MultiExpTest, MultiExpSamePoint)
+{
+    // All points fall in the same buckets, so that every addition is a
+    // doubling.
+    const size_t n = 3000;
+    const std::vector<G1> points(n, G1::one());
+    const std::vector<Fr> scalars(n, Fr(12345));
+    ASSERT_EQ(
+        Fr(n * 12345) * G1::one(),
+        libzeth::multi_exp<Fr, G1>(
+            points.begin(), points.end(), scalars.begin(), scalars.end()));
+}
+
+TEST(MultiExpTest, MultiExpMismatchedSizes)
+{
+    const std::vector<G1> points(10, G1::one());
+    const std::vector<Fr> scalars(9, Fr::one());
+    ASSERT_THROW(
+        libzeth::multi_exp<Fr, G1>(
+            points.begin(), points.end(), scalars.begin(), scalars.end()),
+        std::invalid_argument);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    ppT::init_public_params();
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
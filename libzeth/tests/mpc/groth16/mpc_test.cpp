@@ -4,6 +4,7 @@
 
 #include "libzeth/circuits/circuit_types.hpp"
 #include "libzeth/circuits/sha256/sha256_ethereum.hpp"
+#include "libzeth/core/cancellation.hpp"
 #include "libzeth/core/chacha_rng.hpp"
 #include "libzeth/core/evaluator_from_lagrange.hpp"
 #include "libzeth/core/multi_exp.hpp"
@@ -348,6 +349,9 @@ TEST(MPCTests, Layer2)
         ASSERT_EQ(keypair2.pk.delta_g2, keypair.pk.delta_g2);
         ASSERT_EQ(keypair2.pk.A_query, keypair.pk.A_query);
         ASSERT_EQ(keypair2.pk.B_query, keypair.pk.B_query);
+        // Zero entries are omitted from B_query, as in the libsnark key.
+        ASSERT_EQ(keypair2.pk.B_query.indices, keypair.pk.B_query.indices);
+        ASSERT_EQ(num_variables + 1, keypair.pk.B_query.domain_size());
         ASSERT_EQ(keypair2.pk.H_query, keypair.pk.H_query);
         ASSERT_EQ(keypair2.pk.L_query, keypair.pk.L_query);
 
@@ -362,6 +366,18 @@ TEST(MPCTests, Layer2)
             r1cs_gg_ppzksnark_prover(keypair.pk, primary, auxiliary, true);
         ASSERT_TRUE(
             r1cs_gg_ppzksnark_verifier_strong_IC(keypair.vk, primary, proof));
+
+        // The zero points of the key are dropped by the affine proving key,
+        // which must produce valid proofs.
+        const groth16_snark<ppT>::AffineProvingKeyT affine_pk(
+            r1cs_gg_ppzksnark_proving_key<ppT>(keypair.pk));
+        ASSERT_TRUE(keypair.pk == affine_pk.to_proving_key());
+        const cancellation_token cancellation;
+        const r1cs_gg_ppzksnark_proof<ppT> affine_proof =
+            groth16_snark<ppT>::generate_proof(
+                affine_pk, primary, auxiliary, cancellation);
+        ASSERT_TRUE(r1cs_gg_ppzksnark_verifier_strong_IC(
+            keypair.vk, primary, affine_proof));
     }
 }
 
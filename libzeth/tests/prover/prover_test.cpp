@@ -135,10 +135,38 @@ bool TestValidJS2In2Case1(
     outputs[1] = note_dummy_output;
     libff::leave_block("Create JSOutput/zeth_note", true);
 
-    libff::enter_block("Generate proof", true);
     std::array<FieldT, 2> roots;
     roots[0] = updated_root_value;
     roots[1] = updated_root_value;
+
+    libff::enter_block("Generate witness", true);
+    // A witness context allocates the same variables as the wrapper's
+    // protoboard, and the witness generated in it satisfies the wrapper's
+    // constraint system (generate_witness throws otherwise).
+    typename prover<snarkT>::witness_context context;
+    EXPECT_EQ(
+        prover.get_protoboard().num_variables(),
+        context.get_protoboard().num_variables());
+    EXPECT_EQ(
+        prover.get_protoboard().num_inputs(),
+        context.get_protoboard().num_inputs());
+    libsnark::r1cs_primary_input<FieldT> primary_input;
+    libsnark::r1cs_auxiliary_input<FieldT> auxiliary_input;
+    prover.generate_witness(
+        roots,
+        inputs,
+        outputs,
+        bits64_from_hex("0000000000000000"), // vpub_in = 0
+        value_pub_out_bits64,
+        h_sig,
+        phi,
+        context,
+        true, // check_satisfiability
+        primary_input,
+        auxiliary_input);
+    libff::leave_block("Generate witness", true);
+
+    libff::enter_block("Generate proof", true);
     extended_proof<ppT, snarkT> ext_proof = prover.prove(
         roots,
         inputs,
@@ -149,6 +177,7 @@ bool TestValidJS2In2Case1(
         phi,
         keypair.pk);
     libff::leave_block("Generate proof", true);
+    EXPECT_EQ(primary_input, ext_proof.get_primary_inputs());
 
     libff::enter_block("Verify proof", true);
     // Get the verification key
@@ -0,0 +1,303 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#include "libzeth/circuits/circuit_types.hpp"
+#include "libzeth/core/affine_point.hpp"
+#include "libzeth/core/cancellation.hpp"
+#include "libzeth/snarks/groth16/groth16_mapped_keypair.hpp"
+#include "libzeth/snarks/groth16/groth16_snark.hpp"
+#include "libzeth/tests/circuits/simple_test.hpp"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace libzeth;
+
+using Fr = libff::Fr<ppT>;
+using snark = groth16_snark<ppT>;
+
+namespace
+{
+
+static const groth16_mapped_keypair_checks all_checks = {true, true};
+
+static snark::KeypairT generate_simple_keypair(libsnark::protoboard<Fr> &pb)
+{
+    libzeth::test::simple_circuit<Fr>(pb);
+    return snark::generate_setup(pb);
+}
+
+static boost::filesystem::path write_mapped_keypair(
+    const snark::KeypairT &keypair, const std::string &name)
+{
+    const boost::filesystem::path path =
+        boost::filesystem::temp_directory_path() /
+        boost::filesystem::unique_path(name + "-%%%%-%%%%");
+    std::ofstream out(path.c_str(), std::ios_base::out | std::ios_base::binary);
+    groth16_mapped_keypair_write<ppT>(keypair, out);
+    return path;
+}
+
+static size_t padded_size(size_t size)
+{
+    const size_t alignment = GROTH16_MAPPED_KEYPAIR_ALIGNMENT;
+    return ((size + alignment - 1) / alignment) * alignment;
+}
+
+// Offset, in the payload, of the indices of A_query (the section following
+// the individual key elements).
+static size_t a_query_indices_offset()
+{
+    return padded_size(
+        4 * sizeof(libff::G1<ppT>) + 2 * sizeof(libff::G2<ppT>));
+}
+
+// Offset, in the payload, of the indices of B_query (the section following
+// the indices and points of A_query).
+static size_t b_query_indices_offset(
+    const groth16_mapped_keypair_header &header)
+{
+    return a_query_indices_offset() +
+           padded_size(header.num_a_query * sizeof(uint64_t)) +
+           padded_size(
+               header.num_a_query * sizeof(affine_point<libff::G1<ppT>>));
+}
+
+static groth16_mapped_keypair_header read_header(
+    const boost::filesystem::path &path)
+{
+    std::ifstream in(path.c_str(), std::ios_base::binary);
+    groth16_mapped_keypair_header header;
+    in.read((char *)&header, sizeof(header));
+    return header;
+}
+
+static void write_header(
+    const boost::filesystem::path &path,
+    const groth16_mapped_keypair_header &header)
+{
+    std::fstream f(
+        path.c_str(),
+        std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    f.write((const char *)&header, sizeof(header));
+}
+
+// Overwrite the 64-bit value at `offset` in the payload of a mapped keypair
+// file.
+static void overwrite_payload_value(
+    const boost::filesystem::path &path, size_t offset, uint64_t value)
+{
+    const groth16_mapped_keypair_header header = read_header(path);
+    std::fstream f(
+        path.c_str(),
+        std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    f.seekp(header.header_size + offset);
+    f.write((const char *)&value, sizeof(value));
+}
+
+TEST(Groth16MappedKeypairTest, WriteAndLoad)
+{
+    libsnark::protoboard<Fr> pb;
+    const snark::KeypairT keypair = generate_simple_keypair(pb);
+    const boost::filesystem::path path =
+        write_mapped_keypair(keypair, "mapped_keypair");
+
+    {
+        std::ifstream in(path.c_str(), std::ios_base::binary);
+        ASSERT_TRUE(groth16_mapped_keypair_detect(in));
+    }
+
+    const snark::KeypairT loaded =
+        groth16_mapped_keypair_load<ppT>(path.string(), all_checks);
+    boost::filesystem::remove(path);
+
+    ASSERT_TRUE(keypair.pk == loaded.pk);
+    ASSERT_TRUE(keypair.vk == loaded.vk);
+
+    // Check that the loaded key can be used to generate a valid proof
+    // (x = 3, y = 27 + 36 + 6 + 5 = 74).
+    const libsnark::r1cs_primary_input<Fr> primary{Fr(74)};
+    const libsnark::r1cs_auxiliary_input<Fr> auxiliary{Fr(3), Fr(9), Fr(27)};
+    const snark::ProofT proof =
+        snark::generate_proof(loaded.pk, primary, auxiliary);
+    ASSERT_TRUE(snark::verify(primary, proof, loaded.vk));
+}
+
+TEST(Groth16MappedKeypairTest, WriteAndAttach)
+{
+    libsnark::protoboard<Fr> pb;
+    const snark::KeypairT keypair = generate_simple_keypair(pb);
+    const boost::filesystem::path path =
+        write_mapped_keypair(keypair, "mapped_keypair_attach");
+
+    snark::VerificationKeyT vk;
+    snark::AffineProvingKeyT pk =
+        groth16_mapped_keypair_attach<ppT>(path.string(), all_checks, vk);
+    // The key holds the mapping, which remains valid after the file has
+    // been removed.
+    boost::filesystem::remove(path);
+
+    ASSERT_TRUE(keypair.vk == vk);
+    ASSERT_TRUE(keypair.pk == pk.to_proving_key());
+
+    const libsnark::r1cs_primary_input<Fr> primary{Fr(74)};
+    const libsnark::r1cs_auxiliary_input<Fr> auxiliary{Fr(3), Fr(9), Fr(27)};
+    const cancellation_token cancellation;
+    const snark::ProofT proof =
+        snark::generate_proof(pk, primary, auxiliary, cancellation);
+    ASSERT_TRUE(snark::verify(primary, proof, vk));
+}
+
+TEST(Groth16MappedKeypairTest, DetectLegacyFormat)
+{
+    libsnark::protoboard<Fr> pb;
+    const snark::KeypairT keypair = generate_simple_keypair(pb);
+    std::stringstream ss;
+    snark::keypair_write_bytes(ss, keypair);
+    ASSERT_FALSE(groth16_mapped_keypair_detect(ss));
+}
+
+TEST(Groth16MappedKeypairTest, DetectShortStream)
+{
+    // Shorter than the magic, with exceptions enabled (as when loading a
+    // keypair): reported as not mapped, and the stream is left usable.
+    std::stringstream ss("zeth");
+    ss.exceptions(
+        std::ios_base::eofbit | std::ios_base::badbit | std::ios_base::failbit);
+    ASSERT_FALSE(groth16_mapped_keypair_detect(ss));
+    ASSERT_TRUE(ss.good());
+    ASSERT_EQ(
+        std::ios_base::eofbit | std::ios_base::badbit | std::ios_base::failbit,
+        ss.exceptions());
+}
+
+TEST(Groth16MappedKeypairTest, RejectCorruptedPayload)
+{
+    libsnark::protoboard<Fr> pb;
+    const snark::KeypairT keypair = generate_simple_keypair(pb);
+    const boost::filesystem::path path =
+        write_mapped_keypair(keypair, "mapped_keypair_corrupt");
+
+    // Flip a byte at the end of the file (in the verification key section).
+    {
+        std::fstream f(
+            path.c_str(),
+            std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+        f.seekg(-1, std::ios_base::end);
+        const char c = (char)f.peek();
+        f.seekp(-1, std::ios_base::end);
+        f.put(c ^ 0x01);
+    }
+
+    ASSERT_THROW(
+        groth16_mapped_keypair_load<ppT>(path.string(), all_checks),
+        std::invalid_argument);
+    boost::filesystem::remove(path);
+}
+
+TEST(Groth16MappedKeypairTest, RejectOutOfRangeQueryIndex)
+{
+    libsnark::protoboard<Fr> pb;
+    const snark::KeypairT keypair = generate_simple_keypair(pb);
+    const boost::filesystem::path path =
+        write_mapped_keypair(keypair, "mapped_keypair_index");
+
+    // Point the first entry of A_query beyond the assignment (which is
+    // padded with the constant 1). Without the checksum, only the index
+    // checks detect this.
+    overwrite_payload_value(
+        path, a_query_indices_offset(), pb.num_variables() + 1);
+    const groth16_mapped_keypair_checks no_checks = {false, false};
+
+    snark::VerificationKeyT vk;
+    ASSERT_THROW(
+        groth16_mapped_keypair_attach<ppT>(path.string(), no_checks, vk),
+        std::invalid_argument);
+    ASSERT_THROW(
+        groth16_mapped_keypair_load<ppT>(path.string(), no_checks),
+        std::invalid_argument);
+    boost::filesystem::remove(path);
+}
+
+TEST(Groth16MappedKeypairTest, RejectUnsortedQueryIndices)
+{
+    libsnark::protoboard<Fr> pb;
+    const snark::KeypairT keypair = generate_simple_keypair(pb);
+    const boost::filesystem::path path =
+        write_mapped_keypair(keypair, "mapped_keypair_unsorted");
+
+    // Give the first entry of A_query the index of the last variable, which
+    // is in range, but not below the index of the next entry.
+    overwrite_payload_value(
+        path, a_query_indices_offset(), pb.num_variables());
+    const groth16_mapped_keypair_checks no_checks = {false, false};
+
+    snark::VerificationKeyT vk;
+    ASSERT_THROW(
+        groth16_mapped_keypair_attach<ppT>(path.string(), no_checks, vk),
+        std::invalid_argument);
+    boost::filesystem::remove(path);
+}
+
+TEST(Groth16MappedKeypairTest, RejectOutOfRangeBQueryIndex)
+{
+    libsnark::protoboard<Fr> pb;
+    const snark::KeypairT keypair = generate_simple_keypair(pb);
+    const boost::filesystem::path path =
+        write_mapped_keypair(keypair, "mapped_keypair_b_index");
+
+    // Point the first entry of B_query at the end of its domain.
+    const groth16_mapped_keypair_header header = read_header(path);
+    overwrite_payload_value(
+        path, b_query_indices_offset(header), header.b_query_domain_size);
+    const groth16_mapped_keypair_checks no_checks = {false, false};
+
+    snark::VerificationKeyT vk;
+    ASSERT_THROW(
+        groth16_mapped_keypair_load<ppT>(path.string(), no_checks),
+        std::invalid_argument);
+    ASSERT_THROW(
+        groth16_mapped_keypair_attach<ppT>(path.string(), no_checks, vk),
+        std::invalid_argument);
+    boost::filesystem::remove(path);
+}
+
+TEST(Groth16MappedKeypairTest, RejectMismatchedNumTerms)
+{
+    libsnark::protoboard<Fr> pb;
+    const snark::KeypairT keypair = generate_simple_keypair(pb);
+    const boost::filesystem::path path =
+        write_mapped_keypair(keypair, "mapped_keypair_num_terms");
+
+    // The header is not covered by the checksum.
+    groth16_mapped_keypair_header header = read_header(path);
+    header.num_terms += 1;
+    write_header(path, header);
+
+    snark::VerificationKeyT vk;
+    ASSERT_THROW(
+        groth16_mapped_keypair_load<ppT>(path.string(), all_checks),
+        std::invalid_argument);
+    ASSERT_THROW(
+        groth16_mapped_keypair_attach<ppT>(path.string(), all_checks, vk),
+        std::invalid_argument);
+    boost::filesystem::remove(path);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    // !!! WARNING: Do not forget to do this once for all tests !!!
+    ppT::init_public_params();
+
+    // Remove stdout noise from libff
+    libff::inhibit_profiling_counters = true;
+    libff::inhibit_profiling_info = true;
+
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
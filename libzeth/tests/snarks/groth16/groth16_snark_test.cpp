@@ -0,0 +1,168 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#include "libzeth/circuits/circuit_types.hpp"
+#include "libzeth/core/cancellation.hpp"
+#include "libzeth/snarks/groth16/groth16_snark.hpp"
+#include "libzeth/tests/circuits/simple_test.hpp"
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <vector>
+
+using namespace libzeth;
+
+using Fr = libff::Fr<ppT>;
+using snark = groth16_snark<ppT>;
+
+namespace
+{
+
+// Satisfying assignment for the simple circuit (x = 3, y = 27 + 36 + 6 + 5).
+const libsnark::r1cs_primary_input<Fr> primary{Fr(74)};
+const libsnark::r1cs_auxiliary_input<Fr> auxiliary{Fr(3), Fr(9), Fr(27)};
+
+TEST(Groth16SnarkTest, GenerateProof)
+{
+    libsnark::protoboard<Fr> pb;
+    libzeth::test::simple_circuit<Fr>(pb);
+    const snark::KeypairT keypair = snark::generate_setup(pb);
+
+    const cancellation_token cancellation;
+    const snark::ProofT proof =
+        snark::generate_proof(keypair.pk, primary, auxiliary, cancellation);
+    ASSERT_TRUE(snark::verify(primary, proof, keypair.vk));
+
+    // The proof must be rejected for a different public input.
+    const libsnark::r1cs_primary_input<Fr> wrong_primary{Fr(75)};
+    ASSERT_FALSE(snark::verify(wrong_primary, proof, keypair.vk));
+
+    // Proofs from the libsnark prover and the libzeth prover are
+    // interchangeable.
+    const snark::ProofT libsnark_proof =
+        libsnark::r1cs_gg_ppzksnark_prover<ppT>(
+            keypair.pk, primary, auxiliary, true);
+    ASSERT_TRUE(snark::verify(primary, libsnark_proof, keypair.vk));
+}
+
+TEST(Groth16SnarkTest, GenerateProofCancelled)
+{
+    libsnark::protoboard<Fr> pb;
+    libzeth::test::simple_circuit<Fr>(pb);
+    const snark::KeypairT keypair = snark::generate_setup(pb);
+
+    cancellation_token cancellation;
+    cancellation.cancel();
+    ASSERT_THROW(
+        snark::generate_proof(keypair.pk, primary, auxiliary, cancellation),
+        operation_cancelled);
+}
+
+TEST(Groth16SnarkTest, GenerateProofAffineProvingKey)
+{
+    libsnark::protoboard<Fr> pb;
+    libzeth::test::simple_circuit<Fr>(pb);
+    const snark::KeypairT keypair = snark::generate_setup(pb);
+
+    // Convert a copy of the proving key, via the byte format.
+    std::stringstream ss;
+    snark::proving_key_write_bytes(keypair.pk, ss);
+    const snark::AffineProvingKeyT affine_pk =
+        snark::affine_proving_key_read_bytes(ss);
+    ASSERT_TRUE(keypair.pk == affine_pk.to_proving_key());
+
+    // Zero points are not stored.
+    for (const affine_point<libff::G1<ppT>> &point : affine_pk.A_query) {
+        ASSERT_FALSE(point.is_zero());
+    }
+    for (const affine_point<libff::G1<ppT>> &point : affine_pk.L_query) {
+        ASSERT_FALSE(point.is_zero());
+    }
+
+    const cancellation_token cancellation;
+    const snark::ProofT proof =
+        snark::generate_proof(affine_pk, primary, auxiliary, cancellation);
+    ASSERT_TRUE(snark::verify(primary, proof, keypair.vk));
+
+    const libsnark::r1cs_primary_input<Fr> wrong_primary{Fr(75)};
+    ASSERT_FALSE(snark::verify(wrong_primary, proof, keypair.vk));
+
+    cancellation_token cancelled;
+    cancelled.cancel();
+    ASSERT_THROW(
+        snark::generate_proof(affine_pk, primary, auxiliary, cancelled),
+        operation_cancelled);
+}
+
+TEST(Groth16SnarkTest, VerifyPrepared)
+{
+    libsnark::protoboard<Fr> pb;
+    libzeth::test::simple_circuit<Fr>(pb);
+    const snark::KeypairT keypair = snark::generate_setup(pb);
+    const snark::PreparedVerificationKeyT pvk =
+        snark::prepare_verification_key(keypair.vk);
+    ASSERT_EQ(primary.size(), pvk.num_primary_inputs());
+
+    // The prepared key must accept and reject the same proofs as the
+    // libsnark verifier.
+    const snark::ProofT proof =
+        snark::generate_proof(keypair.pk, primary, auxiliary);
+    ASSERT_TRUE(snark::verify(primary, proof, keypair.vk));
+    ASSERT_TRUE(snark::verify(primary, proof, pvk));
+
+    const libsnark::r1cs_primary_input<Fr> wrong_primary{Fr(75)};
+    ASSERT_FALSE(snark::verify(wrong_primary, proof, keypair.vk));
+    ASSERT_FALSE(snark::verify(wrong_primary, proof, pvk));
+
+    const libsnark::r1cs_primary_input<Fr> too_many_inputs{Fr(74), Fr(0)};
+    ASSERT_FALSE(snark::verify(too_many_inputs, proof, pvk));
+
+    snark::ProofT wrong_proof = proof;
+    wrong_proof.g_C = wrong_proof.g_C + libff::G1<ppT>::one();
+    ASSERT_FALSE(snark::verify(primary, wrong_proof, keypair.vk));
+    ASSERT_FALSE(snark::verify(primary, wrong_proof, pvk));
+}
+
+TEST(Groth16SnarkTest, VerifyBatch)
+{
+    libsnark::protoboard<Fr> pb;
+    libzeth::test::simple_circuit<Fr>(pb);
+    const snark::KeypairT keypair = snark::generate_setup(pb);
+    const snark::PreparedVerificationKeyT pvk =
+        snark::prepare_verification_key(keypair.vk);
+
+    std::vector<libsnark::r1cs_primary_input<Fr>> primary_inputs;
+    std::vector<snark::ProofT> proofs;
+    for (size_t i = 0; i < 4; ++i) {
+        primary_inputs.push_back(primary);
+        proofs.push_back(snark::generate_proof(keypair.pk, primary, auxiliary));
+        ASSERT_TRUE(snark::verify(primary, proofs.back(), pvk));
+    }
+    ASSERT_TRUE(snark::verify_batch(primary_inputs, proofs, pvk));
+    ASSERT_TRUE(snark::verify_batch({}, {}, pvk));
+
+    // A single invalid proof (or input) invalidates the batch.
+    primary_inputs[2] = libsnark::r1cs_primary_input<Fr>{Fr(75)};
+    ASSERT_FALSE(snark::verify(primary_inputs[2], proofs[2], pvk));
+    ASSERT_FALSE(snark::verify_batch(primary_inputs, proofs, pvk));
+
+    primary_inputs[2] = primary;
+    std::swap(proofs[1].g_A, proofs[3].g_A);
+    ASSERT_FALSE(snark::verify_batch(primary_inputs, proofs, pvk));
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    // !!! WARNING: Do not forget to do this once for all tests !!!
+    ppT::init_public_params();
+
+    // Remove stdout noise from libff
+    libff::inhibit_profiling_counters = true;
+    libff::inhibit_profiling_info = true;
+
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,30 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#include "async_call.hpp"
+
+async_call::async_call() : refs(0) {}
+
+async_call::~async_call() {}
+
+void async_call::add_ref() { ++refs; }
+
+void async_call::release()
+{
+    if (--refs == 0) {
+        delete this;
+    }
+}
+
+void run_completion_queue(grpc::CompletionQueue *cq)
+{
+    void *event_tag;
+    bool ok;
+    while (cq->Next(&event_tag, &ok)) {
+        async_call::tag *t = static_cast<async_call::tag *>(event_tag);
+        async_call *call = t->call;
+        call->on_event(t->event, ok);
+        call->release();
+    }
+}
@@ -0,0 +1,52 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_PROVER_SERVER_ASYNC_CALL_HPP__
+#define __ZETH_PROVER_SERVER_ASYNC_CALL_HPP__
+
+#include <atomic>
+#include <cstddef>
+#include <grpcpp/completion_queue.h>
+
+/// State of an asynchronous gRPC call, driven by the events of a completion
+/// queue. Every pending operation (on the completion queue, or elsewhere such
+/// as a proving job) holds a reference to the call. The call deletes itself
+/// when the last reference is released.
+class async_call
+{
+public:
+    /// Tag passed to the completion queue when starting an operation. The
+    /// reference held by the operation is released once its completion has
+    /// been handled.
+    struct tag {
+        async_call *call;
+        int event;
+    };
+
+    async_call();
+    virtual ~async_call();
+
+    async_call(const async_call &) = delete;
+    async_call &operator=(const async_call &) = delete;
+
+    /// Take a reference, before starting an operation.
+    void add_ref();
+
+    /// Release a reference, deleting the call if it was the last one.
+    void release();
+
+    /// Handle the completion of an operation started with a tag of this call.
+    /// `ok` is the status reported by the completion queue.
+    virtual void on_event(int event, bool ok) = 0;
+
+private:
+    std::atomic<size_t> refs;
+};
+
+/// Handle the events of `cq` until it is shut down and drained. Each queue is
+/// polled by a single thread, so that the events of a call are handled in the
+/// order in which they are delivered.
+void run_completion_queue(grpc::CompletionQueue *cq);
+
+#endif // __ZETH_PROVER_SERVER_ASYNC_CALL_HPP__
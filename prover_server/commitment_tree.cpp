@@ -0,0 +1,52 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#include "commitment_tree.hpp"
+
+#include <stdexcept>
+#include <string>
+
+commitment_tree::commitment_tree() : tree(libzeth::ZETH_MERKLE_TREE_DEPTH) {}
+
+void commitment_tree::append(
+    size_t first_address,
+    const std::vector<libzeth::FieldT> &commitments,
+    size_t &num_commitments,
+    libzeth::FieldT &root)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (first_address != tree.num_leaves()) {
+        throw std::invalid_argument(
+            "commitments must be appended at address " +
+            std::to_string(tree.num_leaves()));
+    }
+
+    tree.append_batch(commitments);
+    num_commitments = tree.num_leaves();
+    root = tree.get_root();
+}
+
+void commitment_tree::get_state(
+    size_t &num_commitments, libzeth::FieldT &root) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    num_commitments = tree.num_leaves();
+    root = tree.get_root();
+}
+
+void commitment_tree::get_path(
+    size_t address,
+    std::vector<libzeth::FieldT> &path,
+    libzeth::FieldT &root) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (address >= tree.capacity()) {
+        throw std::invalid_argument(
+            "address " + std::to_string(address) +
+            " out of range of the commitment tree");
+    }
+
+    path = tree.get_path(address);
+    root = tree.get_root();
+}
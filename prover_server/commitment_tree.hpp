@@ -0,0 +1,57 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_PROVER_SERVER_COMMITMENT_TREE_HPP__
+#define __ZETH_PROVER_SERVER_COMMITMENT_TREE_HPP__
+
+#include "libzeth/circuits/circuit_types.hpp"
+#include "libzeth/core/append_merkle_tree_field.hpp"
+#include "libzeth/zeth_constants.hpp"
+
+#include <mutex>
+#include <vector>
+
+/// Copy of the mixer commitment tree, maintained by the server so that
+/// clients do not need to send Merkle paths with each request. The tree is
+/// append-only, and may be read and extended concurrently.
+class commitment_tree
+{
+public:
+    using tree_t = libzeth::append_merkle_tree_field<
+        libzeth::FieldT,
+        libzeth::HashTreeT>;
+
+    commitment_tree();
+
+    /// Append commitments, starting at `first_address`, which must be the
+    /// current number of commitments (so that lost or repeated calls are
+    /// detected). Throws `std::invalid_argument` otherwise. Returns the new
+    /// number of commitments and root in `num_commitments` and `root`.
+    void append(
+        size_t first_address,
+        const std::vector<libzeth::FieldT> &commitments,
+        size_t &num_commitments,
+        libzeth::FieldT &root);
+
+    /// Current number of commitments and root.
+    void get_state(size_t &num_commitments, libzeth::FieldT &root) const;
+
+    /// Merkle path of the commitment at `address`, and the root that it
+    /// authenticates against, taken from the same state of the tree.
+    /// Addresses which have not been appended yet are accepted (their path
+    /// is made of default nodes), since zero-valued (dummy) inputs may use
+    /// any address, including on an empty tree. Throws
+    /// `std::invalid_argument` if `address` is beyond the capacity of the
+    /// tree.
+    void get_path(
+        size_t address,
+        std::vector<libzeth::FieldT> &path,
+        libzeth::FieldT &root) const;
+
+private:
+    mutable std::mutex mutex;
+    tree_t tree;
+};
+
+#endif // __ZETH_PROVER_SERVER_COMMITMENT_TREE_HPP__
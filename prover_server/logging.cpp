@@ -0,0 +1,91 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#include "logging.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+
+namespace
+{
+
+std::atomic<int> max_log_level((int)log_level::info);
+std::mutex log_mutex;
+
+const char *log_level_to_string(log_level level)
+{
+    switch (level) {
+    case log_level::error:
+        return "error";
+    case log_level::warning:
+        return "warning";
+    case log_level::info:
+        return "info";
+    case log_level::debug:
+        return "debug";
+    }
+    return "unknown";
+}
+
+} // namespace
+
+log_level log_level_from_string(const std::string &name)
+{
+    if (name == "error") {
+        return log_level::error;
+    }
+    if (name == "warning") {
+        return log_level::warning;
+    }
+    if (name == "info") {
+        return log_level::info;
+    }
+    if (name == "debug") {
+        return log_level::debug;
+    }
+    throw std::invalid_argument("invalid log level: " + name);
+}
+
+void set_log_level(log_level level) { max_log_level = (int)level; }
+
+bool log_enabled(log_level level) { return (int)level <= max_log_level; }
+
+log_line::log_line(log_level level, const char *event)
+{
+    const long long now_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    line << "ts=" << now_ms << " level=" << log_level_to_string(level)
+         << " event=" << event;
+}
+
+log_line::~log_line()
+{
+    line << '\n';
+    const std::string str = line.str();
+    std::lock_guard<std::mutex> lock(log_mutex);
+    std::cout << str << std::flush;
+}
+
+log_line &log_line::field(const char *key, const std::string &value)
+{
+    line << ' ' << key << "=\"";
+    for (const char c : value) {
+        if (c == '"' || c == '\\') {
+            line << '\\';
+        }
+        line << (c == '\n' ? ' ' : c);
+    }
+    line << '"';
+    return *this;
+}
+
+log_line &log_line::field(const char *key, const char *value)
+{
+    return field(key, std::string(value));
+}
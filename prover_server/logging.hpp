@@ -0,0 +1,59 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_PROVER_SERVER_LOGGING_HPP__
+#define __ZETH_PROVER_SERVER_LOGGING_HPP__
+
+#include <sstream>
+#include <string>
+
+/// Severity of a log line. Lines with a level above the configured level are
+/// discarded without being formatted.
+enum class log_level { error = 0, warning = 1, info = 2, debug = 3 };
+
+/// Parse a level name ("error", "warning", "info" or "debug"). Throws
+/// `std::invalid_argument` on unrecognized names.
+log_level log_level_from_string(const std::string &name);
+
+/// Set the maximum level of lines written to the log (default: info).
+void set_log_level(log_level level);
+
+bool log_enabled(log_level level);
+
+/// A single structured log line, of the form:
+///
+///   ts=<unix time ms> level=<level> event=<event> [<key>=<value> ...]
+///
+/// The line is written (to stdout) when the object is destroyed, atomically
+/// with respect to other threads. Use via the PROVER_LOG macro, so that
+/// fields are not formatted when the level is disabled.
+class log_line
+{
+public:
+    log_line(log_level level, const char *event);
+    ~log_line();
+
+    log_line(const log_line &) = delete;
+    log_line &operator=(const log_line &) = delete;
+
+    template<typename T> log_line &field(const char *key, const T &value)
+    {
+        line << ' ' << key << '=' << value;
+        return *this;
+    }
+
+    /// Add a (quoted) string field.
+    log_line &field(const char *key, const std::string &value);
+    log_line &field(const char *key, const char *value);
+
+private:
+    std::ostringstream line;
+};
+
+#define PROVER_LOG(level, event)                                               \
+    if (!log_enabled(level)) {                                                 \
+    } else                                                                     \
+        log_line(level, event)
+
+#endif // __ZETH_PROVER_SERVER_LOGGING_HPP__
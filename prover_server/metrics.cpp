@@ -0,0 +1,178 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#include "metrics.hpp"
+
+#include <string>
+
+namespace
+{
+
+const char *rpc_method_names[] = {
+    "GetVerificationKey",
+    "Prove",
+    "ProveBatch",
+    "GetMetrics",
+    "AppendCommitments",
+    "GetCommitmentTreeState",
+    "Verify",
+    "VerifyBatch"};
+
+const char *phase_names[] = {
+    "parse", "witness_wait", "witness", "proof_wait", "proof", "serialize"};
+
+// Indexed by gRPC status code.
+const char *status_code_names[] = {
+    "OK",
+    "CANCELLED",
+    "UNKNOWN",
+    "INVALID_ARGUMENT",
+    "DEADLINE_EXCEEDED",
+    "NOT_FOUND",
+    "ALREADY_EXISTS",
+    "PERMISSION_DENIED",
+    "RESOURCE_EXHAUSTED",
+    "FAILED_PRECONDITION",
+    "ABORTED",
+    "OUT_OF_RANGE",
+    "UNIMPLEMENTED",
+    "INTERNAL",
+    "UNAVAILABLE",
+    "DATA_LOSS",
+    "UNAUTHENTICATED"};
+
+} // namespace
+
+const std::array<double, duration_histogram::num_buckets>
+    duration_histogram::upper_bounds = {{0.001,
+                                         0.005,
+                                         0.01,
+                                         0.025,
+                                         0.05,
+                                         0.1,
+                                         0.25,
+                                         0.5,
+                                         1.0,
+                                         2.5,
+                                         5.0,
+                                         10.0,
+                                         25.0,
+                                         60.0,
+                                         120.0,
+                                         300.0}};
+
+duration_histogram::duration_histogram() : count(0), sum_us(0)
+{
+    for (std::atomic<uint64_t> &c : bucket_counts) {
+        c = 0;
+    }
+}
+
+void duration_histogram::observe(std::chrono::steady_clock::duration d)
+{
+    const uint64_t us =
+        std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+    const double seconds = (double)us / 1e6;
+    size_t bucket = 0;
+    while (bucket < num_buckets && seconds > upper_bounds[bucket]) {
+        ++bucket;
+    }
+    ++bucket_counts[bucket];
+    ++count;
+    sum_us += us;
+}
+
+void duration_histogram::write_prometheus(
+    std::ostream &os, const char *name, const char *labels) const
+{
+    const std::string sep = (*labels == '\0') ? "" : ",";
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < num_buckets; ++i) {
+        cumulative += bucket_counts[i];
+        os << name << "_bucket{" << labels << sep << "le=\""
+           << upper_bounds[i] << "\"} " << cumulative << "\n";
+    }
+    cumulative += bucket_counts[num_buckets];
+    os << name << "_bucket{" << labels << sep << "le=\"+Inf\"} " << cumulative
+       << "\n";
+    os << name << "_sum{" << labels << "} " << (double)sum_us / 1e6 << "\n";
+    os << name << "_count{" << labels << "} " << count << "\n";
+}
+
+prover_metrics::prover_metrics() : proof_cache_hits(0), proof_cache_misses(0)
+{
+    for (auto &method_counts : request_counts) {
+        for (std::atomic<uint64_t> &c : method_counts) {
+            c = 0;
+        }
+    }
+}
+
+void prover_metrics::record_request(rpc_method method, int status_code)
+{
+    if (status_code < 0 || (size_t)status_code >= num_status_codes) {
+        status_code = 2; // UNKNOWN
+    }
+    ++request_counts[(size_t)method][(size_t)status_code];
+}
+
+void prover_metrics::record_phase(
+    phase p, std::chrono::steady_clock::duration d)
+{
+    phase_durations[(size_t)p].observe(d);
+}
+
+void prover_metrics::record_proof_cache_lookup(bool hit)
+{
+    if (hit) {
+        ++proof_cache_hits;
+    } else {
+        ++proof_cache_misses;
+    }
+}
+
+void prover_metrics::write_prometheus(std::ostream &os) const
+{
+    os << "# HELP zeth_prover_requests_total "
+          "Completed calls, by method and gRPC status code.\n"
+       << "# TYPE zeth_prover_requests_total counter\n";
+    for (size_t m = 0; m < (size_t)rpc_method::num_methods; ++m) {
+        for (size_t c = 0; c < num_status_codes; ++c) {
+            const uint64_t value = request_counts[m][c];
+            // Only report the OK status and the errors which did occur.
+            if (value == 0 && c != 0) {
+                continue;
+            }
+            os << "zeth_prover_requests_total{method=\""
+               << rpc_method_names[m] << "\",code=\""
+               << status_code_names[c] << "\"} " << value << "\n";
+        }
+    }
+
+    os << "# HELP zeth_prover_phase_duration_seconds "
+          "Time spent in each phase of proof generation.\n"
+       << "# TYPE zeth_prover_phase_duration_seconds histogram\n";
+    for (size_t p = 0; p < (size_t)phase::num_phases; ++p) {
+        const std::string labels =
+            std::string("phase=\"") + phase_names[p] + "\"";
+        phase_durations[p].write_prometheus(
+            os, "zeth_prover_phase_duration_seconds", labels.c_str());
+    }
+
+    os << "# HELP zeth_prover_proof_cache_lookups_total "
+          "Proof cache lookups, by result.\n"
+       << "# TYPE zeth_prover_proof_cache_lookups_total counter\n"
+       << "zeth_prover_proof_cache_lookups_total{result=\"hit\"} "
+       << proof_cache_hits << "\n"
+       << "zeth_prover_proof_cache_lookups_total{result=\"miss\"} "
+       << proof_cache_misses << "\n";
+}
+
+void write_prometheus_gauge(
+    std::ostream &os, const char *name, const char *help, double value)
+{
+    os << "# HELP " << name << " " << help << "\n"
+       << "# TYPE " << name << " gauge\n"
+       << name << " " << value << "\n";
+}
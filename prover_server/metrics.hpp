@@ -0,0 +1,99 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_PROVER_SERVER_METRICS_HPP__
+#define __ZETH_PROVER_SERVER_METRICS_HPP__
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+/// Histogram of durations, with fixed buckets (in seconds) suitable for
+/// proof generation phases (from 1ms to a few minutes). All operations are
+/// lock-free, so that observing a duration is cheap on the request path.
+class duration_histogram
+{
+public:
+    static const size_t num_buckets = 16;
+
+    duration_histogram();
+
+    void observe(std::chrono::steady_clock::duration d);
+
+    /// Write the `_bucket`, `_sum` and `_count` samples of the histogram in
+    /// the Prometheus text format. `labels` (e.g. `phase="proof"`) is added
+    /// to each sample, and may be empty.
+    void write_prometheus(
+        std::ostream &os, const char *name, const char *labels) const;
+
+private:
+    static const std::array<double, num_buckets> upper_bounds;
+
+    // Number of samples in each bucket (not cumulative). The last entry
+    // counts the samples above the largest bound.
+    std::array<std::atomic<uint64_t>, num_buckets + 1> bucket_counts;
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> sum_us;
+};
+
+/// Metrics collected by the prover server. Counters and histograms are
+/// updated as requests are processed. Gauges (queue depth, etc.) are sampled
+/// by the server when the metrics are exported.
+class prover_metrics
+{
+public:
+    enum class rpc_method {
+        get_verification_key = 0,
+        prove,
+        prove_batch,
+        get_metrics,
+        append_commitments,
+        get_commitment_tree_state,
+        verify,
+        verify_batch,
+        num_methods
+    };
+
+    enum class phase {
+        parse = 0,
+        witness_wait,
+        witness,
+        proof_wait,
+        proof,
+        serialize,
+        num_phases
+    };
+
+    prover_metrics();
+
+    /// Record the completion of a call, with its gRPC status code.
+    void record_request(rpc_method method, int status_code);
+
+    void record_phase(phase p, std::chrono::steady_clock::duration d);
+
+    void record_proof_cache_lookup(bool hit);
+
+    /// Write all counters and histograms in the Prometheus text format.
+    void write_prometheus(std::ostream &os) const;
+
+private:
+    // gRPC status codes are in the range [0, 16].
+    static const size_t num_status_codes = 17;
+
+    std::array<
+        std::array<std::atomic<uint64_t>, num_status_codes>,
+        (size_t)rpc_method::num_methods>
+        request_counts;
+    std::array<duration_histogram, (size_t)phase::num_phases> phase_durations;
+    std::atomic<uint64_t> proof_cache_hits;
+    std::atomic<uint64_t> proof_cache_misses;
+};
+
+/// Write a single gauge in the Prometheus text format.
+void write_prometheus_gauge(
+    std::ostream &os, const char *name, const char *help, double value);
+
+#endif // __ZETH_PROVER_SERVER_METRICS_HPP__
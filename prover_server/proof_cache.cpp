@@ -0,0 +1,113 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#include "proof_cache.hpp"
+
+#include "libzeth/mpc/groth16/mpc_hash.hpp"
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <iterator>
+
+namespace
+{
+
+// Approximate memory used by the bookkeeping of each entry (list node, index
+// node and key), in addition to the proof itself.
+const size_t entry_overhead_bytes = 256;
+
+} // namespace
+
+proof_cache::proof_cache(size_t max_bytes, std::chrono::seconds ttl)
+    : max_bytes(max_bytes), ttl(ttl), bytes(0)
+{
+}
+
+std::string proof_cache::key(const zeth_proto::ProofInputs &proof_inputs)
+{
+    std::string serialized;
+    {
+        google::protobuf::io::StringOutputStream string_stream(&serialized);
+        google::protobuf::io::CodedOutputStream coded_stream(&string_stream);
+        coded_stream.SetSerializationDeterministic(true);
+        proof_inputs.SerializeToCodedStream(&coded_stream);
+    }
+
+    libzeth::mpc_hash_t digest;
+    libzeth::mpc_compute_hash(digest, serialized);
+    return std::string((const char *)digest, sizeof(digest));
+}
+
+bool proof_cache::is_cacheable(const zeth_proto::ProofInputs &proof_inputs)
+{
+    for (const std::string &root : proof_inputs.mk_roots()) {
+        if (root.empty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool proof_cache::lookup(
+    const std::string &key, zeth_proto::ExtendedProof &proof)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = index.find(key);
+    if (found == index.end()) {
+        return false;
+    }
+
+    std::list<entry>::iterator it = found->second;
+    if (clock::now() >= it->expiry) {
+        erase(it);
+        return false;
+    }
+
+    entries.splice(entries.begin(), entries, it);
+    proof = it->proof;
+    return true;
+}
+
+void proof_cache::insert(
+    const std::string &key, const zeth_proto::ExtendedProof &proof)
+{
+    const size_t size =
+        proof.ByteSizeLong() + key.size() + entry_overhead_bytes;
+    if (size > max_bytes) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = index.find(key);
+    if (found != index.end()) {
+        erase(found->second);
+    }
+
+    entries.push_front(entry{key, proof, size, clock::now() + ttl});
+    index[key] = entries.begin();
+    bytes += size;
+
+    while (bytes > max_bytes) {
+        erase(std::prev(entries.end()));
+    }
+}
+
+size_t proof_cache::num_entries() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+size_t proof_cache::num_bytes() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return bytes;
+}
+
+void proof_cache::erase(std::list<entry>::iterator it)
+{
+    bytes -= it->size;
+    index.erase(it->key);
+    entries.erase(it);
+}
@@ -0,0 +1,69 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_PROVER_SERVER_PROOF_CACHE_HPP__
+#define __ZETH_PROVER_SERVER_PROOF_CACHE_HPP__
+
+#include <api/snark_messages.pb.h>
+#include <api/zeth_messages.pb.h>
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/// Bounded cache of generated proofs, keyed by a digest of the request
+/// inputs, so that retried requests are answered without generating a new
+/// proof. Entries expire after a fixed time. When the (approximate) memory
+/// used by the entries exceeds a limit, the least recently used entries are
+/// evicted. May be used from several threads concurrently.
+class proof_cache
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    proof_cache(size_t max_bytes, std::chrono::seconds ttl);
+
+    /// Digest (BLAKE2b) of the deterministic serialization of the inputs.
+    static std::string key(const zeth_proto::ProofInputs &proof_inputs);
+
+    /// Returns true if a proof for these inputs may be cached. Inputs which
+    /// leave a Merkle root to be filled in by the server are not cached,
+    /// since the resulting proof depends on the state of the server tree.
+    static bool is_cacheable(const zeth_proto::ProofInputs &proof_inputs);
+
+    /// Copy the proof cached under `key` to `proof`. Returns false if there
+    /// is no such proof (or if it has expired).
+    bool lookup(const std::string &key, zeth_proto::ExtendedProof &proof);
+
+    /// Cache a proof, evicting older entries if necessary. Proofs which are
+    /// larger than the cache itself are ignored.
+    void insert(const std::string &key, const zeth_proto::ExtendedProof &proof);
+
+    size_t num_entries() const;
+
+    size_t num_bytes() const;
+
+private:
+    struct entry {
+        std::string key;
+        zeth_proto::ExtendedProof proof;
+        size_t size;
+        clock::time_point expiry;
+    };
+
+    // Must be called with `mutex` held.
+    void erase(std::list<entry>::iterator it);
+
+    const size_t max_bytes;
+    const std::chrono::seconds ttl;
+
+    mutable std::mutex mutex;
+    // Most recently used first
+    std::list<entry> entries;
+    std::unordered_map<std::string, std::list<entry>::iterator> index;
+    size_t bytes;
+};
+
+#endif // __ZETH_PROVER_SERVER_PROOF_CACHE_HPP__
@@ -0,0 +1,258 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#include "prove_batch_call.hpp"
+
+#include "logging.hpp"
+#include "status_from_exception.hpp"
+
+prover_server::prove_batch_call::prove_batch_call(
+    prover_server &server, grpc::ServerCompletionQueue *cq)
+    : server(server)
+    , cq(cq)
+    , stream(&context)
+    , batch_id(0)
+    , input_request_id(0)
+    , num_received(0)
+    , throttled(false)
+    , reads_done(false)
+    , writing(false)
+    , finishing(false)
+    , request_tag{this, request_received}
+    , read_tag{this, read_done}
+    , write_tag{this, write_done}
+    , finish_tag{this, response_sent}
+    , done_tag{this, call_done}
+{
+}
+
+void prover_server::prove_batch_call::start()
+{
+    context.AsyncNotifyWhenDone(&done_tag);
+    add_ref();
+    server.RequestProveBatch(&context, &stream, cq, cq, &request_tag);
+}
+
+void prover_server::prove_batch_call::on_event(int event, bool ok)
+{
+    switch (event) {
+    case request_received:
+        // Not ok if the server is shutting down.
+        if (ok) {
+            (new prove_batch_call(server, cq))->start();
+            on_request();
+        }
+        break;
+    case read_done:
+        on_read(ok);
+        break;
+    case write_done:
+        on_write(ok);
+        break;
+    case call_done:
+        if (context.IsCancelled()) {
+            on_cancelled();
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void prover_server::prove_batch_call::on_request()
+{
+    // The done tag is only delivered for calls which have started.
+    add_ref();
+
+    batch_id = server.next_request_id++;
+    PROVER_LOG(log_level::info, "prove_batch").field("request", batch_id);
+    std::lock_guard<std::mutex> lock(mutex);
+    start_read();
+}
+
+void prover_server::prove_batch_call::on_cancelled()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (finishing) {
+        return;
+    }
+    PROVER_LOG(log_level::info, "client_cancelled").field("request", batch_id);
+    finish(grpc::Status(grpc::StatusCode::CANCELLED, "batch cancelled"));
+}
+
+void prover_server::prove_batch_call::start_read()
+{
+    add_ref();
+    stream.Read(&input, &read_tag);
+}
+
+void prover_server::prove_batch_call::on_read(bool ok)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (finishing) {
+        return;
+    }
+    if (!ok) {
+        // No more inputs
+        reads_done = true;
+        complete_if_done();
+        return;
+    }
+
+    ++num_received;
+    input_request_id = server.next_request_id++;
+    PROVER_LOG(log_level::debug, "prove_batch_item")
+        .field("request", input_request_id)
+        .field("batch", batch_id);
+
+    input_cache_key = server.proof_cache_key(input);
+    if (push_cached_proof()) {
+        write_next_proof();
+        start_read();
+        return;
+    }
+
+    // If the queue is full, this batch waits for its own earlier jobs to
+    // free up some room (see `resume_if_throttled`). It is only rejected if
+    // it has nothing in flight.
+    if (submit_input()) {
+        start_read();
+    } else if (pending.empty()) {
+        PROVER_LOG(log_level::warning, "queue_full").field("request", batch_id);
+        finish(grpc::Status(
+            grpc::StatusCode::RESOURCE_EXHAUSTED, "proving queue full"));
+    } else {
+        throttled = true;
+    }
+}
+
+bool prover_server::prove_batch_call::push_cached_proof()
+{
+    zeth_proto::ExtendedProof proof;
+    if (!server.lookup_cached_proof(input_request_id, input_cache_key, proof)) {
+        return false;
+    }
+    std::shared_ptr<proving_job> job = std::make_shared<proving_job>(
+        input_request_id,
+        input,
+        input_cache_key,
+        proving_job::completion_handler());
+    job->result.Swap(&proof);
+    job->done = true;
+    pending.push_back(job);
+    return true;
+}
+
+bool prover_server::prove_batch_call::submit_input()
+{
+    // Reference held by the job, released once it has been handled.
+    add_ref();
+    std::shared_ptr<proving_job> job = server.submit_job(
+        input_request_id,
+        input,
+        input_cache_key,
+        [this](proving_job &done_job) { on_job_done(done_job); });
+    if (!job) {
+        release();
+        return false;
+    }
+    pending.push_back(job);
+    return true;
+}
+
+void prover_server::prove_batch_call::on_job_done(proving_job &)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!finishing) {
+            write_next_proof();
+            resume_if_throttled();
+        }
+    }
+    release();
+}
+
+void prover_server::prove_batch_call::on_write(bool ok)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    writing = false;
+    if (finishing) {
+        // Finish was deferred until the end of the write.
+        send_status();
+        return;
+    }
+    if (!ok) {
+        finish(grpc::Status(
+            grpc::StatusCode::CANCELLED, "batch stream closed"));
+        return;
+    }
+    write_next_proof();
+    resume_if_throttled();
+    complete_if_done();
+}
+
+void prover_server::prove_batch_call::write_next_proof()
+{
+    if (writing || pending.empty() || !pending.front()->done) {
+        return;
+    }
+
+    std::shared_ptr<proving_job> job = pending.front();
+    pending.pop_front();
+    if (job->error) {
+        finish(status_from_exception(job->request_id, job->error));
+        return;
+    }
+
+    output.Swap(&job->result);
+    writing = true;
+    add_ref();
+    stream.Write(output, &write_tag);
+}
+
+void prover_server::prove_batch_call::resume_if_throttled()
+{
+    if (!throttled || finishing) {
+        return;
+    }
+    if (submit_input()) {
+        throttled = false;
+        start_read();
+    } else if (pending.empty() && !writing) {
+        PROVER_LOG(log_level::warning, "queue_full").field("request", batch_id);
+        finish(grpc::Status(
+            grpc::StatusCode::RESOURCE_EXHAUSTED, "proving queue full"));
+    }
+}
+
+void prover_server::prove_batch_call::complete_if_done()
+{
+    if (reads_done && !throttled && !writing && pending.empty() && !finishing) {
+        PROVER_LOG(log_level::info, "prove_batch_complete")
+            .field("request", batch_id)
+            .field("num_proofs", num_received);
+        finish(grpc::Status::OK);
+    }
+}
+
+void prover_server::prove_batch_call::finish(const grpc::Status &status)
+{
+    finishing = true;
+    final_status = status;
+    for (const std::shared_ptr<proving_job> &job : pending) {
+        job->cancellation.cancel();
+    }
+    pending.clear();
+    if (!writing) {
+        send_status();
+    }
+}
+
+void prover_server::prove_batch_call::send_status()
+{
+    server.record_request(
+        prover_metrics::rpc_method::prove_batch, final_status);
+    add_ref();
+    stream.Finish(final_status, &finish_tag);
+}
@@ -0,0 +1,111 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_PROVER_SERVER_PROVE_BATCH_CALL_HPP__
+#define __ZETH_PROVER_SERVER_PROVE_BATCH_CALL_HPP__
+
+#include "async_call.hpp"
+#include "proving_job.hpp"
+#include "prover_server.hpp"
+
+#include <api/prover.grpc.pb.h>
+#include <cstdint>
+#include <deque>
+#include <grpcpp/server_context.h>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/// Asynchronous ProveBatch call. Jobs are submitted as the inputs arrive, so
+/// that parsing and proving of the batch is spread over all workers. Proofs
+/// are returned in request order, each as soon as it (and all preceding
+/// proofs) are available. At most one read and one write are in flight at any
+/// time.
+class prover_server::prove_batch_call final : public async_call
+{
+public:
+    prove_batch_call(prover_server &server, grpc::ServerCompletionQueue *cq);
+
+    /// Wait for the next ProveBatch call.
+    void start();
+
+    void on_event(int event, bool ok) override;
+
+private:
+    enum { request_received, read_done, write_done, response_sent, call_done };
+
+    void on_request();
+
+    // Called without `mutex` held. The client has gone away, and the
+    // remaining jobs of the batch are cancelled.
+    void on_cancelled();
+
+    // Unless stated otherwise, the methods below must be called with `mutex`
+    // held.
+
+    void start_read();
+
+    // Called without `mutex` held.
+    void on_read(bool ok);
+
+    /// Serve the last input read from the proof cache, if possible, by
+    /// queueing an already completed job.
+    bool push_cached_proof();
+
+    /// Submit the last input read. Returns false if the queue is full.
+    bool submit_input();
+
+    /// Executed by the worker completing a job (without `mutex` held).
+    void on_job_done(proving_job &);
+
+    // Called without `mutex` held.
+    void on_write(bool ok);
+
+    /// Write the proof of the oldest pending job, if it is complete and no
+    /// other write is in flight. If the job failed, the batch fails.
+    void write_next_proof();
+
+    /// Retry the submission of a throttled input.
+    void resume_if_throttled();
+
+    void complete_if_done();
+
+    /// End the call. The remaining jobs of the batch are cancelled. The
+    /// status is sent once any write in flight has completed.
+    void finish(const grpc::Status &status);
+
+    void send_status();
+
+    prover_server &server;
+    grpc::ServerCompletionQueue *const cq;
+
+    grpc::ServerContext context;
+    grpc::ServerAsyncReaderWriter<
+        zeth_proto::ExtendedProof,
+        zeth_proto::ProofInputs>
+        stream;
+    uint64_t batch_id;
+
+    std::mutex mutex;
+    zeth_proto::ProofInputs input;
+    uint64_t input_request_id;
+    std::string input_cache_key;
+    zeth_proto::ExtendedProof output;
+    std::deque<std::shared_ptr<proving_job>> pending;
+    size_t num_received;
+    // An input has been read but not yet admitted (the queue was full).
+    bool throttled;
+    bool reads_done;
+    bool writing;
+    bool finishing;
+    grpc::Status final_status;
+
+    tag request_tag;
+    tag read_tag;
+    tag write_tag;
+    tag finish_tag;
+    tag done_tag;
+};
+
+#endif // __ZETH_PROVER_SERVER_PROVE_BATCH_CALL_HPP__
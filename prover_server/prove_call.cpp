@@ -0,0 +1,156 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#include "prove_call.hpp"
+
+#include "logging.hpp"
+#include "status_from_exception.hpp"
+
+#include <chrono>
+
+prover_server::prove_call::prove_call(
+    prover_server &server, grpc::ServerCompletionQueue *cq)
+    : server(server)
+    , cq(cq)
+    , responder(&context)
+    , request_id(0)
+    , alarm_set(false)
+    , finished(false)
+    , request_tag{this, request_received}
+    , alarm_tag{this, alarm_fired}
+    , finish_tag{this, response_sent}
+    , done_tag{this, call_done}
+{
+}
+
+void prover_server::prove_call::start()
+{
+    context.AsyncNotifyWhenDone(&done_tag);
+    add_ref();
+    server.RequestProve(
+        &context, &proof_inputs, &responder, cq, cq, &request_tag);
+}
+
+void prover_server::prove_call::on_event(int event, bool ok)
+{
+    switch (event) {
+    case request_received:
+        // Not ok if the server is shutting down.
+        if (ok) {
+            (new prove_call(server, cq))->start();
+            on_request();
+        }
+        break;
+    case alarm_fired:
+        // Not ok if the alarm was cancelled.
+        if (ok) {
+            on_timeout();
+        }
+        break;
+    case call_done:
+        if (context.IsCancelled()) {
+            on_cancelled();
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void prover_server::prove_call::on_request()
+{
+    // The done tag is only delivered for calls which have started.
+    add_ref();
+
+    request_id = server.next_request_id++;
+    PROVER_LOG(log_level::info, "prove").field("request", request_id);
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    const std::string cache_key = server.proof_cache_key(proof_inputs);
+    if (server.lookup_cached_proof(request_id, cache_key, proof)) {
+        finish(grpc::Status::OK);
+        return;
+    }
+
+    // Reference held by the job, released once it has been handled.
+    add_ref();
+    job = server.submit_job(
+        request_id,
+        proof_inputs,
+        cache_key,
+        [this](proving_job &done_job) { on_job_done(done_job); });
+    if (!job) {
+        release();
+        PROVER_LOG(log_level::warning, "queue_full")
+            .field("request", request_id);
+        finish(grpc::Status(
+            grpc::StatusCode::RESOURCE_EXHAUSTED, "proving queue full"));
+        return;
+    }
+
+    if (server.request_timeout.count() != 0) {
+        add_ref();
+        alarm.Set(
+            cq,
+            std::chrono::system_clock::now() + server.request_timeout,
+            &alarm_tag);
+        alarm_set = true;
+    }
+}
+
+void prover_server::prove_call::on_job_done(proving_job &done_job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!finished) {
+            if (done_job.error) {
+                finish(status_from_exception(request_id, done_job.error));
+            } else {
+                proof.Swap(&done_job.result);
+                finish(grpc::Status::OK);
+            }
+        }
+    }
+    release();
+}
+
+void prover_server::prove_call::on_timeout()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (finished) {
+        return;
+    }
+    job->cancellation.cancel();
+    PROVER_LOG(log_level::error, "request_timeout")
+        .field("request", request_id);
+    finish(grpc::Status(
+        grpc::StatusCode::DEADLINE_EXCEEDED, "proof generation timed out"));
+}
+
+void prover_server::prove_call::on_cancelled()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (finished) {
+        return;
+    }
+    PROVER_LOG(log_level::info, "client_cancelled")
+        .field("request", request_id);
+    job->cancellation.cancel();
+}
+
+void prover_server::prove_call::finish(const grpc::Status &status)
+{
+    finished = true;
+    server.record_request(prover_metrics::rpc_method::prove, status);
+    add_ref();
+    if (status.ok()) {
+        responder.Finish(proof, status, &finish_tag);
+    } else {
+        responder.FinishWithError(status, &finish_tag);
+    }
+    if (alarm_set) {
+        alarm.Cancel();
+    }
+}
@@ -0,0 +1,72 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_PROVER_SERVER_PROVE_CALL_HPP__
+#define __ZETH_PROVER_SERVER_PROVE_CALL_HPP__
+
+#include "async_call.hpp"
+#include "proving_job.hpp"
+#include "prover_server.hpp"
+
+#include <api/prover.grpc.pb.h>
+#include <cstdint>
+#include <grpcpp/alarm.h>
+#include <grpcpp/server_context.h>
+#include <memory>
+#include <mutex>
+
+/// Asynchronous Prove call. The request is handed over to the proving
+/// workers, and the response is sent by the worker completing the job (or
+/// on timeout, whichever comes first). The job is cancelled on timeout, or if
+/// the call is cancelled by the client (including when the client deadline
+/// expires).
+class prover_server::prove_call final : public async_call
+{
+public:
+    prove_call(prover_server &server, grpc::ServerCompletionQueue *cq);
+
+    /// Wait for the next Prove call.
+    void start();
+
+    void on_event(int event, bool ok) override;
+
+private:
+    enum { request_received, alarm_fired, response_sent, call_done };
+
+    void on_request();
+
+    /// Executed by the worker completing the job.
+    void on_job_done(proving_job &done_job);
+
+    void on_timeout();
+
+    /// The client has gone away. The job is cancelled, and the response is
+    /// sent (and discarded by gRPC) once the worker has abandoned it.
+    void on_cancelled();
+
+    /// Send the response. Must be called with `mutex` held.
+    void finish(const grpc::Status &status);
+
+    prover_server &server;
+    grpc::ServerCompletionQueue *const cq;
+
+    grpc::ServerContext context;
+    zeth_proto::ProofInputs proof_inputs;
+    zeth_proto::ExtendedProof proof;
+    grpc::ServerAsyncResponseWriter<zeth_proto::ExtendedProof> responder;
+    uint64_t request_id;
+
+    std::mutex mutex;
+    std::shared_ptr<proving_job> job;
+    grpc::Alarm alarm;
+    bool alarm_set;
+    bool finished;
+
+    tag request_tag;
+    tag alarm_tag;
+    tag finish_tag;
+    tag done_tag;
+};
+
+#endif // __ZETH_PROVER_SERVER_PROVE_CALL_HPP__
@@ -2,29 +2,37 @@
 //
 // SPDX-License-Identifier: LGPL-3.0+
 
-#include "libzeth/circuits/circuit_types.hpp"
-#include "libzeth/core/extended_proof.hpp"
+#include "prover_server.hpp"
+
 #include "libzeth/core/utils.hpp"
 #include "libzeth/serialization/proto_utils.hpp"
 #include "libzeth/serialization/r1cs_serialization.hpp"
 #include "libzeth/snarks/default/default_api_handler.hpp"
-#include "libzeth/zeth_constants.hpp"
+#ifdef ZKSNARK_GROTH16
+#include "libzeth/snarks/groth16/groth16_mapped_keypair.hpp"
+#endif
+#include "async_call.hpp"
+#include "logging.hpp"
+#include "prove_batch_call.hpp"
+#include "prove_call.hpp"
+#include "status_from_exception.hpp"
 #include "zeth_config.h"
 
-#include <api/prover.grpc.pb.h>
+#include <algorithm>
 #include <boost/program_options.hpp>
 #include <fstream>
 #include <grpc/grpc.h>
 #include <grpcpp/security/server_credentials.h>
 #include <grpcpp/server.h>
 #include <grpcpp/server_builder.h>
-#include <grpcpp/server_context.h>
 #include <libsnark/common/data_structures/merkle_tree.hpp>
-#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
 #include <stdio.h>
-#include <string>
+#include <thread>
+#include <vector>
 
-using snark = libzeth::default_snark<libzeth::ppT>;
 using api_handler = libzeth::default_api_handler<libzeth::ppT>;
 
 namespace proto = google::protobuf;
@@ -62,9 +70,8 @@ static void serialize_setup_to_file(
     }
 }
 
-static void write_ext_proof_to_file(
-    const libzeth::extended_proof<libzeth::ppT, snark> &ext_proof,
-    boost::filesystem::path proof_path = "")
+static void write_ext_proof_json_to_file(
+    const std::string &ext_proof_json, boost::filesystem::path proof_path = "")
 {
     if (proof_path.empty()) {
         // Used for debugging
@@ -73,181 +80,645 @@ static void write_ext_proof_to_file(
         proof_path = tmp_path / "proof_and_inputs.json";
     }
 
-    std::cout << "[DEBUG] Writing extended proof to" << proof_path << std::endl;
+    PROVER_LOG(log_level::debug, "write_proof")
+        .field("path", proof_path.string());
     std::ofstream os(proof_path.c_str());
-    ext_proof.write_json(os);
+    os << ext_proof_json;
 }
 
-/// The prover_server class inherits from the Prover service
-/// defined in the proto files, and provides an implementation
-/// of the service.
-class prover_server final : public zeth_proto::Prover::Service
+/// Parsed form of a ProofInputs message, as consumed by the circuit_wrapper.
+struct joinsplit_proof_inputs {
+    std::array<libzeth::FieldT, libzeth::ZETH_NUM_JS_INPUTS> roots;
+    std::array<
+        libzeth::joinsplit_input<
+            libzeth::FieldT,
+            libzeth::ZETH_MERKLE_TREE_DEPTH>,
+        libzeth::ZETH_NUM_JS_INPUTS>
+        inputs;
+    std::array<libzeth::zeth_note, libzeth::ZETH_NUM_JS_OUTPUTS> outputs;
+    libzeth::bits64 vpub_in;
+    libzeth::bits64 vpub_out;
+    libzeth::bits256 h_sig;
+    libzeth::bits256 phi;
+};
+
+/// Parse a ProofInputs message. If `tree` is given, inputs without a Merkle
+/// path are completed using the commitment tree.
+static joinsplit_proof_inputs joinsplit_proof_inputs_from_proto(
+    const zeth_proto::ProofInputs &proof_inputs, const commitment_tree *tree)
 {
-private:
-    using FieldT = libff::Fr<libzeth::ppT>;
+    if (libzeth::ZETH_NUM_JS_INPUTS != proof_inputs.mk_roots_size()) {
+        throw std::invalid_argument("Invalid number of Merkle roots");
+    }
+    if (libzeth::ZETH_NUM_JS_INPUTS != proof_inputs.js_inputs_size()) {
+        throw std::invalid_argument("Invalid number of JS inputs");
+    }
+    if (libzeth::ZETH_NUM_JS_OUTPUTS != proof_inputs.js_outputs_size()) {
+        throw std::invalid_argument("Invalid number of JS outputs");
+    }
 
-    libzeth::circuit_wrapper<
-        libzeth::HashT,
-        libzeth::HashTreeT,
-        libzeth::ppT,
-        snark,
-        libzeth::ZETH_NUM_JS_INPUTS,
-        libzeth::ZETH_NUM_JS_OUTPUTS,
-        libzeth::ZETH_MERKLE_TREE_DEPTH>
-        prover;
+    joinsplit_proof_inputs parsed;
+    for (size_t i = 0; i < libzeth::ZETH_NUM_JS_INPUTS; i++) {
+        const zeth_proto::JoinsplitInput &input = proof_inputs.js_inputs(i);
+        if (tree == nullptr || input.merkle_path_size() != 0) {
+            parsed.roots[i] = libzeth::field_element_from_hex<libzeth::FieldT>(
+                proof_inputs.mk_roots(i));
+            parsed.inputs[i] = libzeth::joinsplit_input_from_proto<
+                libzeth::FieldT,
+                libzeth::ZETH_MERKLE_TREE_DEPTH>(input);
+            continue;
+        }
 
-    // The keypair is the result of the setup
-    snark::KeypairT keypair;
-
-public:
-    explicit prover_server(
-        libzeth::circuit_wrapper<
-            libzeth::HashT,
-            libzeth::HashTreeT,
-            libzeth::ppT,
-            snark,
-            libzeth::ZETH_NUM_JS_INPUTS,
-            libzeth::ZETH_NUM_JS_OUTPUTS,
-            libzeth::ZETH_MERKLE_TREE_DEPTH> &prover,
-        snark::KeypairT &keypair)
-        : prover(prover), keypair(keypair)
-    {
+        // The path and root are taken from the same state of the tree. A
+        // root given by the client must match it.
+        std::vector<libzeth::FieldT> merkle_path;
+        libzeth::FieldT tree_root;
+        tree->get_path((size_t)input.address(), merkle_path, tree_root);
+        if (!proof_inputs.mk_roots(i).empty() &&
+            libzeth::field_element_from_hex<libzeth::FieldT>(
+                proof_inputs.mk_roots(i)) != tree_root) {
+            throw std::invalid_argument(
+                "Merkle root does not match the commitment tree");
+        }
+
+        parsed.roots[i] = tree_root;
+        parsed.inputs[i] = libzeth::joinsplit_input<
+            libzeth::FieldT,
+            libzeth::ZETH_MERKLE_TREE_DEPTH>(
+            merkle_path,
+            libzeth::bits_addr_from_size_t<libzeth::ZETH_MERKLE_TREE_DEPTH>(
+                input.address()),
+            libzeth::zeth_note_from_proto(input.note()),
+            libzeth::bits256_from_hex(input.spending_ask()),
+            libzeth::bits256_from_hex(input.nullifier()));
     }
+    parsed.vpub_in = libzeth::bits64_from_hex(proof_inputs.pub_in_value());
+    parsed.vpub_out = libzeth::bits64_from_hex(proof_inputs.pub_out_value());
+    parsed.h_sig = libzeth::bits256_from_hex(proof_inputs.h_sig());
+    parsed.phi = libzeth::bits256_from_hex(proof_inputs.phi());
 
-    grpc::Status GetVerificationKey(
-        grpc::ServerContext *,
-        const proto::Empty *,
-        zeth_proto::VerificationKey *response) override
-    {
-        std::cout << "[ACK] Received the request to get the verification key"
-                  << std::endl;
-        std::cout << "[DEBUG] Preparing verification key for response..."
-                  << std::endl;
-        try {
-            api_handler::verification_key_to_proto(this->keypair.vk, response);
-        } catch (const std::exception &e) {
-            std::cout << "[ERROR] " << e.what() << std::endl;
-            return grpc::Status(
-                grpc::StatusCode::INVALID_ARGUMENT, grpc::string(e.what()));
-        } catch (...) {
-            std::cout << "[ERROR] In catch all" << std::endl;
-            return grpc::Status(grpc::StatusCode::UNKNOWN, "");
+    for (size_t i = 0; i < libzeth::ZETH_NUM_JS_OUTPUTS; i++) {
+        parsed.outputs[i] =
+            libzeth::zeth_note_from_proto(proof_inputs.js_outputs(i));
+    }
+
+    return parsed;
+}
+
+static uint64_t elapsed_ms(
+    proving_job::clock::time_point from, proving_job::clock::time_point to)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(to - from)
+        .count();
+}
+
+/// Share the available cores between the proving workers, so that concurrent
+/// proofs do not oversubscribe the machine. `reserved_cores` are left for
+/// other threads (e.g. the witness stage of the pipeline). A single worker
+/// with no reserved cores keeps the OpenMP default (0).
+static size_t omp_threads_per_worker(size_t num_workers, size_t reserved_cores)
+{
+    const size_t num_cores = std::thread::hardware_concurrency();
+    if ((num_workers <= 1 && reserved_cores == 0) || num_cores == 0) {
+        return 0;
+    }
+    const size_t available =
+        (num_cores > reserved_cores) ? num_cores - reserved_cores : 1;
+    return std::max<size_t>(1, available / num_workers);
+}
+
+#ifdef ZKSNARK_GROTH16
+/// Approximate memory used by a constraint system.
+static size_t constraint_system_memory_size(
+    const libsnark::r1cs_constraint_system<libzeth::FieldT> &cs)
+{
+    size_t size = 0;
+    for (const libsnark::r1cs_constraint<libzeth::FieldT> &constraint :
+         cs.constraints) {
+        size += sizeof(constraint) +
+                (constraint.a.terms.size() + constraint.b.terms.size() +
+                 constraint.c.terms.size()) *
+                    sizeof(libsnark::linear_term<libzeth::FieldT>);
+    }
+    return size;
+}
+#endif
+
+/// Approximate memory used by the proving key in use (group elements and the
+/// constraint system).
+static size_t proving_key_memory_size(
+    const snark::ProvingKeyT &pk, const prover_server_options &options)
+{
+#ifdef ZKSNARK_GROTH16
+    if (options.affine_proving_key != nullptr) {
+        return options.affine_proving_key->memory_size() +
+               constraint_system_memory_size(
+                   options.affine_proving_key->constraint_system);
+    }
+
+    using G1 = libff::G1<libzeth::ppT>;
+    using G2 = libff::G2<libzeth::ppT>;
+    return pk.A_query.size() * sizeof(G1) +
+           pk.B_query.values.size() *
+               sizeof(libsnark::knowledge_commitment<G2, G1>) +
+           pk.B_query.indices.size() * sizeof(size_t) +
+           pk.H_query.size() * sizeof(G1) + pk.L_query.size() * sizeof(G1) +
+           constraint_system_memory_size(pk.constraint_system);
+#else
+    (void)options;
+    // Serialized size, as an approximation.
+    return pk.size_in_bits() / 8;
+#endif
+}
+
+/// Decide whether the witness of a request should be checked, such that a
+/// fraction `rate` of all requests are checked.
+static bool sample_witness_check(double rate)
+{
+    if (rate <= 0.0) {
+        return false;
+    }
+    if (rate >= 1.0) {
+        return true;
+    }
+    static thread_local std::minstd_rand rng(std::random_device{}());
+    return std::bernoulli_distribution(rate)(rng);
+}
+
+prover_server::prover_server(
+    const prover_circuit &prover,
+    const snark::KeypairT &keypair,
+    const prover_server_options &options)
+    : prover(prover)
+    , keypair(keypair)
+#ifdef ZKSNARK_GROTH16
+    , affine_proving_key(options.affine_proving_key)
+#endif
+    , request_timeout(options.request_timeout)
+    , witness_check_rate(options.witness_check_rate)
+    , dump_proofs(options.dump_proofs)
+    , next_request_id(0)
+    , proving_key_bytes(proving_key_memory_size(keypair.pk, options))
+    , prepared_vk(snark::prepare_verification_key(keypair.vk))
+    , dump_writer(1, 16, 0)
+    // In pipelined mode, admission control happens at the witness stage, and
+    // the witness thread blocks while a proof stage is already waiting for a
+    // worker (see `hand_over_to_proof_stage`). Jobs in flight are therefore
+    // bounded by max_queued (waiting for the witness thread), plus one being
+    // witnessed, one waiting for a worker and one per worker.
+    , pool(
+          options.num_workers,
+          options.pipeline ? 1 : options.max_queued,
+          omp_threads_per_worker(options.num_workers, options.pipeline ? 1 : 0))
+{
+    if (options.pipeline) {
+        witness_pool.reset(new proving_pool(1, options.max_queued, 1));
+    }
+    if (options.commitment_tree) {
+        commitments.reset(new commitment_tree());
+    }
+    if (options.proof_cache_bytes != 0) {
+        cache.reset(new proof_cache(
+            options.proof_cache_bytes, options.proof_cache_ttl));
+    }
+
+    PROVER_LOG(log_level::info, "server_config")
+        .field("workers", options.num_workers)
+        .field("queue_size", options.max_queued)
+        .field("timeout_s", options.request_timeout.count())
+        .field("witness_check_rate", options.witness_check_rate)
+        .field("dump_proofs", options.dump_proofs)
+        .field("pipeline", options.pipeline)
+        .field("commitment_tree", options.commitment_tree)
+        .field("rpc_threads", options.rpc_threads)
+        .field("proof_cache_bytes", options.proof_cache_bytes)
+        .field("proof_cache_ttl_s", options.proof_cache_ttl.count());
+}
+
+grpc::Status prover_server::GetVerificationKey(
+    grpc::ServerContext *,
+    const proto::Empty *,
+    zeth_proto::VerificationKey *response)
+{
+    const uint64_t request_id = next_request_id++;
+    PROVER_LOG(log_level::info, "get_verification_key")
+        .field("request", request_id);
+    try {
+        api_handler::verification_key_to_proto(this->keypair.vk, response);
+    } catch (...) {
+        return record_request(
+            prover_metrics::rpc_method::get_verification_key,
+            status_from_exception(request_id, std::current_exception()));
+    }
+
+    return record_request(
+        prover_metrics::rpc_method::get_verification_key, grpc::Status::OK);
+}
+
+void prover_server::start_async_calls(grpc::ServerCompletionQueue *cq)
+{
+    (new prove_call(*this, cq))->start();
+    (new prove_batch_call(*this, cq))->start();
+}
+
+grpc::Status prover_server::GetMetrics(
+    grpc::ServerContext *, const proto::Empty *, zeth_proto::Metrics *response)
+{
+    std::ostringstream os;
+    metrics.write_prometheus(os);
+
+    size_t num_queued = pool.num_queued();
+    if (witness_pool) {
+        num_queued += witness_pool->num_queued();
+    }
+    write_prometheus_gauge(
+        os,
+        "zeth_prover_queue_depth",
+        "Requests waiting for a worker.",
+        (double)num_queued);
+    write_prometheus_gauge(
+        os,
+        "zeth_prover_active_workers",
+        "Proving workers currently generating a proof.",
+        (double)pool.num_active());
+    write_prometheus_gauge(
+        os,
+        "zeth_prover_workers",
+        "Number of proving workers.",
+        (double)pool.num_workers());
+    write_prometheus_gauge(
+        os,
+        "zeth_prover_proving_key_bytes",
+        "Memory used by the proving key.",
+        (double)proving_key_bytes);
+    if (cache) {
+        write_prometheus_gauge(
+            os,
+            "zeth_prover_proof_cache_entries",
+            "Number of proofs in the proof cache.",
+            (double)cache->num_entries());
+        write_prometheus_gauge(
+            os,
+            "zeth_prover_proof_cache_bytes",
+            "Approximate memory used by the proof cache.",
+            (double)cache->num_bytes());
+    }
+
+    response->set_prometheus_text(os.str());
+    return record_request(
+        prover_metrics::rpc_method::get_metrics, grpc::Status::OK);
+}
+
+grpc::Status prover_server::AppendCommitments(
+    grpc::ServerContext *,
+    const zeth_proto::CommitmentBatch *batch,
+    zeth_proto::CommitmentTreeState *response)
+{
+    const uint64_t request_id = next_request_id++;
+    PROVER_LOG(log_level::debug, "append_commitments")
+        .field("request", request_id)
+        .field("first_address", batch->first_address())
+        .field("num_commitments", batch->commitments_size());
+    if (!commitments) {
+        return record_request(
+            prover_metrics::rpc_method::append_commitments,
+            grpc::Status(
+                grpc::StatusCode::FAILED_PRECONDITION,
+                "commitment tree not enabled"));
+    }
+
+    try {
+        std::vector<libzeth::FieldT> leaves;
+        leaves.reserve(batch->commitments_size());
+        for (const std::string &commitment : batch->commitments()) {
+            leaves.push_back(
+                libzeth::field_element_from_hex<libzeth::FieldT>(commitment));
         }
 
-        return grpc::Status::OK;
+        size_t num_commitments;
+        libzeth::FieldT root;
+        commitments->append(
+            (size_t)batch->first_address(), leaves, num_commitments, root);
+        response->set_num_commitments(num_commitments);
+        response->set_root(libzeth::field_element_to_hex(root));
+    } catch (...) {
+        return record_request(
+            prover_metrics::rpc_method::append_commitments,
+            status_from_exception(request_id, std::current_exception()));
     }
 
-    grpc::Status Prove(
-        grpc::ServerContext *,
-        const zeth_proto::ProofInputs *proof_inputs,
-        zeth_proto::ExtendedProof *proof) override
-    {
-        std::cout << "[ACK] Received the request to generate a proof"
-                  << std::endl;
-        std::cout << "[DEBUG] Parse received message to compute proof..."
-                  << std::endl;
+    return record_request(
+        prover_metrics::rpc_method::append_commitments, grpc::Status::OK);
+}
 
-        // Parse received message to feed to the prover
-        try {
-            /*
-            libzeth::FieldT root =
-                libzeth::field_element_from_hex<libzeth::FieldT>(
-                    proof_inputs->mk_root());
-            */
-            std::array<FieldT, 2> roots;
-            roots[0] = libzeth::field_element_from_hex<libzeth::FieldT>(
-                    proof_inputs->mk_roots(0));
-            roots[1] = libzeth::field_element_from_hex<libzeth::FieldT>(
-                    proof_inputs->mk_roots(1));
-            libzeth::bits64 vpub_in =
-                libzeth::bits64_from_hex(proof_inputs->pub_in_value());
-            libzeth::bits64 vpub_out =
-                libzeth::bits64_from_hex(proof_inputs->pub_out_value());
-            libzeth::bits256 h_sig_in =
-                libzeth::bits256_from_hex(proof_inputs->h_sig());
-            libzeth::bits256 phi_in =
-                libzeth::bits256_from_hex(proof_inputs->phi());
-
-            if (libzeth::ZETH_NUM_JS_INPUTS != proof_inputs->js_inputs_size()) {
-                throw std::invalid_argument("Invalid number of JS inputs");
+grpc::Status prover_server::GetCommitmentTreeState(
+    grpc::ServerContext *,
+    const proto::Empty *,
+    zeth_proto::CommitmentTreeState *response)
+{
+    if (!commitments) {
+        return record_request(
+            prover_metrics::rpc_method::get_commitment_tree_state,
+            grpc::Status(
+                grpc::StatusCode::FAILED_PRECONDITION,
+                "commitment tree not enabled"));
+    }
+
+    size_t num_commitments;
+    libzeth::FieldT root;
+    commitments->get_state(num_commitments, root);
+    response->set_num_commitments(num_commitments);
+    response->set_root(libzeth::field_element_to_hex(root));
+    return record_request(
+        prover_metrics::rpc_method::get_commitment_tree_state,
+        grpc::Status::OK);
+}
+
+grpc::Status prover_server::Verify(
+    grpc::ServerContext *,
+    const zeth_proto::ExtendedProof *proof,
+    zeth_proto::VerificationResult *response)
+{
+    const uint64_t request_id = next_request_id++;
+    PROVER_LOG(log_level::debug, "verify").field("request", request_id);
+    try {
+        const libzeth::extended_proof<libzeth::ppT, snark> ext_proof =
+            api_handler::extended_proof_from_proto(*proof);
+        response->set_valid(snark::verify(
+            ext_proof.get_primary_inputs(),
+            ext_proof.get_proof(),
+            prepared_vk));
+    } catch (...) {
+        return record_request(
+            prover_metrics::rpc_method::verify,
+            status_from_exception(request_id, std::current_exception()));
+    }
+
+    return record_request(prover_metrics::rpc_method::verify, grpc::Status::OK);
+}
+
+grpc::Status prover_server::VerifyBatch(
+    grpc::ServerContext *,
+    const zeth_proto::ExtendedProofs *request,
+    zeth_proto::VerificationResults *response)
+{
+    const uint64_t request_id = next_request_id++;
+    PROVER_LOG(log_level::debug, "verify_batch")
+        .field("request", request_id)
+        .field("num_proofs", request->proofs_size());
+    try {
+        std::vector<libsnark::r1cs_primary_input<libzeth::FieldT>>
+            primary_inputs;
+        std::vector<snark::ProofT> proofs;
+        primary_inputs.reserve(request->proofs_size());
+        proofs.reserve(request->proofs_size());
+        for (const zeth_proto::ExtendedProof &proof : request->proofs()) {
+            const libzeth::extended_proof<libzeth::ppT, snark> ext_proof =
+                api_handler::extended_proof_from_proto(proof);
+            primary_inputs.push_back(ext_proof.get_primary_inputs());
+            proofs.push_back(ext_proof.get_proof());
+        }
+
+        // The proofs are only checked individually (to find the invalid
+        // ones) if the batch check fails.
+        const bool all_valid =
+            snark::verify_batch(primary_inputs, proofs, prepared_vk);
+        if (!all_valid) {
+            PROVER_LOG(log_level::info, "verify_batch_invalid")
+                .field("request", request_id);
+        }
+        for (size_t i = 0; i < proofs.size(); ++i) {
+            response->add_valid(
+                all_valid ||
+                snark::verify(primary_inputs[i], proofs[i], prepared_vk));
+        }
+    } catch (...) {
+        return record_request(
+            prover_metrics::rpc_method::verify_batch,
+            status_from_exception(request_id, std::current_exception()));
+    }
+
+    return record_request(
+        prover_metrics::rpc_method::verify_batch, grpc::Status::OK);
+}
+
+grpc::Status prover_server::record_request(
+    prover_metrics::rpc_method method, const grpc::Status &status)
+{
+    metrics.record_request(method, (int)status.error_code());
+    return status;
+}
+
+std::string prover_server::proof_cache_key(
+    const zeth_proto::ProofInputs &proof_inputs) const
+{
+    if (!cache || !proof_cache::is_cacheable(proof_inputs)) {
+        return std::string();
+    }
+    return proof_cache::key(proof_inputs);
+}
+
+bool prover_server::lookup_cached_proof(
+    uint64_t request_id,
+    const std::string &cache_key,
+    zeth_proto::ExtendedProof &proof)
+{
+    if (cache_key.empty()) {
+        return false;
+    }
+    const bool hit = cache->lookup(cache_key, proof);
+    metrics.record_proof_cache_lookup(hit);
+    if (hit) {
+        PROVER_LOG(log_level::info, "proof_cache_hit")
+            .field("request", request_id);
+    }
+    return hit;
+}
+
+std::shared_ptr<proving_job> prover_server::submit_job(
+    uint64_t request_id,
+    const zeth_proto::ProofInputs &proof_inputs,
+    const std::string &cache_key,
+    const proving_job::completion_handler &on_done)
+{
+    std::shared_ptr<proving_job> job = std::make_shared<proving_job>(
+        request_id, proof_inputs, cache_key, on_done);
+    bool admitted;
+    if (witness_pool) {
+        admitted = witness_pool->try_submit([this, job]() {
+            if (execute_witness_stage(*job)) {
+                hand_over_to_proof_stage(job);
             }
-            if (libzeth::ZETH_NUM_JS_OUTPUTS !=
-                proof_inputs->js_outputs_size()) {
-                throw std::invalid_argument("Invalid number of JS outputs");
+        });
+    } else {
+        admitted = pool.try_submit([this, job]() {
+            if (execute_witness_stage(*job)) {
+                execute_proof_stage(*job);
             }
+        });
+    }
+    if (!admitted) {
+        return nullptr;
+    }
+    return job;
+}
 
-            std::cout << "[DEBUG] Process all inputs of the JoinSplit"
-                      << std::endl;
-            std::array<
-                libzeth::joinsplit_input<
-                    libzeth::FieldT,
-                    libzeth::ZETH_MERKLE_TREE_DEPTH>,
-                libzeth::ZETH_NUM_JS_INPUTS>
-                joinsplit_inputs;
-            for (size_t i = 0; i < libzeth::ZETH_NUM_JS_INPUTS; i++) {
-                printf(
-                    "\r  input (%zu / %zu)\n", i, libzeth::ZETH_NUM_JS_INPUTS);
-                zeth_proto::JoinsplitInput received_input =
-                    proof_inputs->js_inputs(i);
-                libzeth::joinsplit_input<
-                    libzeth::FieldT,
-                    libzeth::ZETH_MERKLE_TREE_DEPTH>
-                    parsed_input = libzeth::joinsplit_input_from_proto<
-                        libzeth::FieldT,
-                        libzeth::ZETH_MERKLE_TREE_DEPTH>(received_input);
-                joinsplit_inputs[i] = parsed_input;
-            }
+void prover_server::hand_over_to_proof_stage(
+    const std::shared_ptr<proving_job> &job)
+{
+    if (!pool.submit([this, job]() { execute_proof_stage(*job); })) {
+        complete_job(
+            *job,
+            std::make_exception_ptr(
+                std::runtime_error("prover server is shutting down")));
+    }
+}
 
-            std::cout << "[DEBUG] Process all outputs of the JoinSplit"
-                      << std::endl;
-            std::array<libzeth::zeth_note, libzeth::ZETH_NUM_JS_OUTPUTS>
-                joinsplit_outputs;
-            for (size_t i = 0; i < libzeth::ZETH_NUM_JS_OUTPUTS; i++) {
-                printf(
-                    "\r  output (%zu / %zu)\n",
-                    i,
-                    libzeth::ZETH_NUM_JS_OUTPUTS);
-                zeth_proto::ZethNote received_output =
-                    proof_inputs->js_outputs(i);
-                libzeth::zeth_note parsed_output =
-                    libzeth::zeth_note_from_proto(received_output);
-                joinsplit_outputs[i] = parsed_output;
-            }
+bool prover_server::execute_witness_stage(proving_job &job)
+{
+    try {
+        job.cancellation.check();
+        job.witness_started = proving_job::clock::now();
+        metrics.record_phase(
+            prover_metrics::phase::witness_wait,
+            job.witness_started - job.submitted);
+
+        const joinsplit_proof_inputs parsed =
+            joinsplit_proof_inputs_from_proto(
+                job.proof_inputs, commitments.get());
+        const proving_job::clock::time_point parse_done =
+            proving_job::clock::now();
+        metrics.record_phase(
+            prover_metrics::phase::parse, parse_done - job.witness_started);
 
-            std::cout << "[DEBUG] Data parsed successfully" << std::endl;
-            std::cout << "[DEBUG] Generating the proof..." << std::endl;
-            libzeth::extended_proof<libzeth::ppT, snark> ext_proof =
-                this->prover.prove(
-                    roots,
-                    joinsplit_inputs,
-                    joinsplit_outputs,
-                    vpub_in,
-                    vpub_out,
-                    h_sig_in,
-                    phi_in,
-                    this->keypair.pk);
-
-            std::cout << "[DEBUG] Displaying the extended proof" << std::endl;
-            ext_proof.write_json(std::cout);
-
-            // Write a copy of the proof for debugging.
-            write_ext_proof_to_file(ext_proof);
-
-            std::cout << "[DEBUG] Preparing response..." << std::endl;
-            api_handler::extended_proof_to_proto(ext_proof, proof);
-
-        } catch (const std::exception &e) {
-            std::cout << "[ERROR] " << e.what() << std::endl;
-            return grpc::Status(
-                grpc::StatusCode::INVALID_ARGUMENT, grpc::string(e.what()));
+        job.cancellation.check();
+        const bool check_witness = sample_witness_check(witness_check_rate);
+        PROVER_LOG(log_level::debug, "generate_witness")
+            .field("request", job.request_id)
+            .field("check_witness", check_witness);
+        std::unique_ptr<witness_context> context = witness_contexts.acquire();
+        try {
+            this->prover.generate_witness(
+                parsed.roots,
+                parsed.inputs,
+                parsed.outputs,
+                parsed.vpub_in,
+                parsed.vpub_out,
+                parsed.h_sig,
+                parsed.phi,
+                *context,
+                check_witness,
+                job.primary_input,
+                job.auxiliary_input);
         } catch (...) {
-            std::cout << "[ERROR] In catch all" << std::endl;
-            return grpc::Status(grpc::StatusCode::UNKNOWN, "");
+            witness_contexts.release(std::move(context));
+            throw;
         }
+        witness_contexts.release(std::move(context));
 
-        return grpc::Status::OK;
+        job.witness_done = proving_job::clock::now();
+        metrics.record_phase(
+            prover_metrics::phase::witness, job.witness_done - parse_done);
+        return true;
+    } catch (...) {
+        complete_job(job, std::current_exception());
+        return false;
     }
-};
+}
+
+libzeth::extended_proof<libzeth::ppT, snark> prover_server::generate_proof(
+    const proving_job &job) const
+{
+#ifdef ZKSNARK_GROTH16
+    if (affine_proving_key != nullptr) {
+        const snark::ProofT proof = snark::generate_proof(
+            *affine_proving_key,
+            job.primary_input,
+            job.auxiliary_input,
+            job.cancellation);
+        return libzeth::extended_proof<libzeth::ppT, snark>(
+            proof, job.primary_input);
+    }
+#endif
+    return this->prover.prove_from_witness(
+        this->keypair.pk,
+        job.primary_input,
+        job.auxiliary_input,
+        job.cancellation);
+}
+
+void prover_server::execute_proof_stage(proving_job &job)
+{
+    try {
+        job.cancellation.check();
+        job.proof_started = proving_job::clock::now();
+        metrics.record_phase(
+            prover_metrics::phase::proof_wait,
+            job.proof_started - job.witness_done);
+
+        libzeth::extended_proof<libzeth::ppT, snark> ext_proof =
+            generate_proof(job);
+
+        // The witness is no longer needed, and is large.
+        libsnark::r1cs_auxiliary_input<libzeth::FieldT>().swap(
+            job.auxiliary_input);
+
+        const proving_job::clock::time_point proof_done =
+            proving_job::clock::now();
+        metrics.record_phase(
+            prover_metrics::phase::proof, proof_done - job.proof_started);
+
+        if (dump_proofs) {
+            dump_proof(job.request_id, ext_proof);
+        }
+
+        api_handler::extended_proof_to_proto(ext_proof, &job.result);
+        if (!job.cache_key.empty()) {
+            cache->insert(job.cache_key, job.result);
+        }
+        metrics.record_phase(
+            prover_metrics::phase::serialize,
+            proving_job::clock::now() - proof_done);
+        PROVER_LOG(log_level::info, "proof_generated")
+            .field("request", job.request_id)
+            .field(
+                "witness_wait_ms",
+                elapsed_ms(job.submitted, job.witness_started))
+            .field(
+                "witness_ms", elapsed_ms(job.witness_started, job.witness_done))
+            .field(
+                "proof_wait_ms",
+                elapsed_ms(job.witness_done, job.proof_started))
+            .field("proof_ms", elapsed_ms(job.proof_started, proof_done));
+    } catch (...) {
+        complete_job(job, std::current_exception());
+        return;
+    }
+    complete_job(job, nullptr);
+}
+
+void prover_server::dump_proof(
+    uint64_t request_id,
+    const libzeth::extended_proof<libzeth::ppT, snark> &ext_proof)
+{
+    std::ostringstream ss;
+    ext_proof.write_json(ss);
+    const std::string ext_proof_json = ss.str();
+    PROVER_LOG(log_level::debug, "extended_proof")
+        .field("request", request_id)
+        .field("proof", ext_proof_json);
+    if (!dump_writer.try_submit([ext_proof_json]() {
+            try {
+                write_ext_proof_json_to_file(ext_proof_json);
+            } catch (const std::exception &e) {
+                PROVER_LOG(log_level::warning, "write_proof_failed")
+                    .field("error", e.what());
+            }
+        })) {
+        PROVER_LOG(log_level::warning, "proof_dump_dropped")
+            .field("request", request_id);
+    }
+}
 
 std::string get_server_version()
 {
@@ -285,7 +756,7 @@ void display_server_start_message()
 }
 
 static void RunServer(
-    libzeth::circuit_wrapper<
+    const libzeth::circuit_wrapper<
         libzeth::HashT,
         libzeth::HashTreeT,
         libzeth::ppT,
@@ -293,12 +764,13 @@ static void RunServer(
         libzeth::ZETH_NUM_JS_INPUTS,
         libzeth::ZETH_NUM_JS_OUTPUTS,
         libzeth::ZETH_MERKLE_TREE_DEPTH> &prover,
-    typename snark::KeypairT &keypair)
+    const typename snark::KeypairT &keypair,
+    const prover_server_options &options)
 {
     // Listen for incoming connections on 0.0.0.0:50051
     std::string server_address("0.0.0.0:50051");
 
-    prover_server service(prover, keypair);
+    prover_server service(prover, keypair, options);
 
     grpc::ServerBuilder builder;
 
@@ -306,27 +778,84 @@ static void RunServer(
     builder.AddListeningPort(server_address, grpc::InsecureServerCredentials());
 
     // Register "service" as the instance through which we'll communicate with
-    // clients. In this case it corresponds to an *synchronous* service.
+    // clients. Prove and ProveBatch are *asynchronous*, and are served from
+    // the completion queues below. The other methods are synchronous.
     builder.RegisterService(&service);
+    std::vector<std::unique_ptr<grpc::ServerCompletionQueue>> cqs;
+    for (size_t i = 0; i < options.rpc_threads; ++i) {
+        cqs.push_back(builder.AddCompletionQueue());
+    }
 
     // Finally assemble the server.
     std::unique_ptr<grpc::Server> server(builder.BuildAndStart());
     std::cout << "[DEBUG] Server listening on " << server_address << std::endl;
 
+    std::vector<std::thread> rpc_threads;
+    for (const std::unique_ptr<grpc::ServerCompletionQueue> &cq : cqs) {
+        service.start_async_calls(cq.get());
+        grpc::ServerCompletionQueue *cq_ptr = cq.get();
+        rpc_threads.emplace_back([cq_ptr]() { run_completion_queue(cq_ptr); });
+    }
+
     // Wait for the server to shutdown. Note that some other thread must be
     // responsible for shutting down the server for this call to ever return.
     display_server_start_message();
     server->Wait();
+
+    for (const std::unique_ptr<grpc::ServerCompletionQueue> &cq : cqs) {
+        cq->Shutdown();
+    }
+    for (std::thread &rpc_thread : rpc_threads) {
+        rpc_thread.join();
+    }
 }
 
 #ifdef ZKSNARK_GROTH16
-static snark::KeypairT load_keypair(const std::string &keypair_file)
+/// Load a keypair from a file. If `affine_proving_key` is set and the file
+/// is a mapped keypair, the proving key is attached in place (and shared
+/// with other processes using the same file): it is returned in
+/// `affine_pk`, and the proving key of the returned keypair is empty.
+static snark::KeypairT load_keypair(
+    const std::string &keypair_file,
+    const libzeth::groth16_mapped_keypair_checks &checks,
+    bool affine_proving_key,
+    std::unique_ptr<snark::AffineProvingKeyT> &affine_pk)
 {
     std::ifstream in(keypair_file, std::ios_base::in | std::ios_base::binary);
+    if (!in) {
+        throw std::runtime_error("failed to open keypair file " + keypair_file);
+    }
+
+    // Keypairs in the mapped layout are loaded without parsing.
+    if (libzeth::groth16_mapped_keypair_detect(in)) {
+        std::cout << "[INFO] Mapped keypair format detected" << std::endl;
+        if (affine_proving_key) {
+            std::cout << "[INFO] Attaching to the mapped proving key"
+                      << std::endl;
+            snark::VerificationKeyT vk;
+            affine_pk.reset(new snark::AffineProvingKeyT(
+                libzeth::groth16_mapped_keypair_attach<libzeth::ppT>(
+                    keypair_file, checks, vk)));
+            return snark::KeypairT(snark::ProvingKeyT(), std::move(vk));
+        }
+        return libzeth::groth16_mapped_keypair_load<libzeth::ppT>(
+            keypair_file, checks);
+    }
+
     in.exceptions(
         std::ios_base::eofbit | std::ios_base::badbit | std::ios_base::failbit);
     return snark::keypair_read_bytes(in);
 }
+
+static void write_mapped_keypair(
+    const snark::KeypairT &keypair, const std::string &mapped_keypair_file)
+{
+    std::ofstream out(
+        mapped_keypair_file, std::ios_base::out | std::ios_base::binary);
+    out.exceptions(
+        std::ios_base::eofbit | std::ios_base::badbit | std::ios_base::failbit);
+    libzeth::groth16_mapped_keypair_write<libzeth::ppT>(keypair, out);
+}
 #endif
 
 int main(int argc, char **argv)
@@ -335,6 +864,61 @@ int main(int argc, char **argv)
     po::options_description options("");
     options.add_options()(
         "keypair,k", po::value<std::string>(), "file to load keypair from");
+    options.add_options()(
+        "workers,w",
+        po::value<size_t>()->default_value(1),
+        "number of proofs generated concurrently");
+    options.add_options()(
+        "queue-size,q",
+        po::value<size_t>()->default_value(16),
+        "maximum number of requests waiting for a worker");
+    options.add_options()(
+        "timeout,t",
+        po::value<size_t>()->default_value(0),
+        "Prove request timeout in seconds (0 for no timeout)");
+    options.add_options()(
+        "log-level",
+        po::value<std::string>()->default_value("info"),
+        "log level: error, warning, info or debug");
+    options.add_options()(
+        "check-witness",
+        po::value<double>()->default_value(0.0),
+        "fraction of requests (0 to 1) for which the witness is checked");
+    options.add_options()(
+        "dump-proofs", "write each generated proof to the debug directory");
+    options.add_options()(
+        "pipeline",
+        "generate witnesses on a dedicated thread, overlapping with proving");
+    options.add_options()(
+        "commitment-tree",
+        "maintain the commitment tree, and fill in missing Merkle paths");
+    options.add_options()(
+        "rpc-threads",
+        po::value<size_t>()->default_value(2),
+        "number of threads receiving Prove and ProveBatch calls");
+    options.add_options()(
+        "proof-cache-mb",
+        po::value<size_t>()->default_value(0),
+        "memory (in MiB) used to cache proofs for retried requests (0 to "
+        "disable)");
+    options.add_options()(
+        "proof-cache-ttl",
+        po::value<size_t>()->default_value(600),
+        "time in seconds after which a cached proof expires");
+#ifdef ZKSNARK_GROTH16
+    options.add_options()(
+        "key-checks",
+        po::value<std::string>()->default_value("full"),
+        "checks when loading a mapped keypair: full, checksum or none");
+    options.add_options()(
+        "write-mapped-keypair",
+        po::value<std::string>(),
+        "file in which to write the keypair in the mapped layout");
+    options.add_options()(
+        "affine-proving-key",
+        "keep the proving key in affine coordinates, using less memory (a "
+        "mapped proving key is used in place, shared between processes)");
+#endif
 #ifdef DEBUG
     options.add_options()(
         "jr1cs,j",
@@ -352,6 +936,12 @@ int main(int argc, char **argv)
     };
 
     std::string keypair_file;
+    prover_server_options server_options;
+#ifdef ZKSNARK_GROTH16
+    libzeth::groth16_mapped_keypair_checks key_checks = {true, true};
+    std::string mapped_keypair_file;
+    bool affine_proving_key = false;
+#endif
 #ifdef DEBUG
     boost::filesystem::path jr1cs_file;
 #endif
@@ -366,6 +956,50 @@ int main(int argc, char **argv)
         if (vm.count("keypair")) {
             keypair_file = vm["keypair"].as<std::string>();
         }
+        server_options.num_workers = vm["workers"].as<size_t>();
+        server_options.max_queued = vm["queue-size"].as<size_t>();
+        server_options.request_timeout =
+            std::chrono::seconds(vm["timeout"].as<size_t>());
+        if (server_options.num_workers == 0) {
+            throw po::error("number of workers must be non-zero");
+        }
+        try {
+            set_log_level(
+                log_level_from_string(vm["log-level"].as<std::string>()));
+        } catch (const std::invalid_argument &e) {
+            throw po::error(e.what());
+        }
+        server_options.witness_check_rate = vm["check-witness"].as<double>();
+        if (server_options.witness_check_rate < 0.0 ||
+            server_options.witness_check_rate > 1.0) {
+            throw po::error("check-witness must be between 0 and 1");
+        }
+        server_options.dump_proofs = vm.count("dump-proofs") != 0;
+        server_options.pipeline = vm.count("pipeline") != 0;
+        server_options.commitment_tree = vm.count("commitment-tree") != 0;
+        server_options.rpc_threads = vm["rpc-threads"].as<size_t>();
+        if (server_options.rpc_threads == 0) {
+            throw po::error("number of rpc threads must be non-zero");
+        }
+        server_options.proof_cache_bytes =
+            vm["proof-cache-mb"].as<size_t>() * 1024 * 1024;
+        server_options.proof_cache_ttl =
+            std::chrono::seconds(vm["proof-cache-ttl"].as<size_t>());
+#ifdef ZKSNARK_GROTH16
+        const std::string key_checks_name = vm["key-checks"].as<std::string>();
+        if (key_checks_name == "checksum") {
+            key_checks.check_well_formed = false;
+        } else if (key_checks_name == "none") {
+            key_checks.verify_checksum = false;
+            key_checks.check_well_formed = false;
+        } else if (key_checks_name != "full") {
+            throw po::error("invalid key-checks: " + key_checks_name);
+        }
+        if (vm.count("write-mapped-keypair")) {
+            mapped_keypair_file = vm["write-mapped-keypair"].as<std::string>();
+        }
+        affine_proving_key = vm.count("affine-proving-key") != 0;
+#endif
 #ifdef DEBUG
         if (vm.count("jr1cs")) {
             jr1cs_file = vm["jr1cs"].as<boost::filesystem::path>();
@@ -390,12 +1024,16 @@ int main(int argc, char **argv)
         libzeth::ZETH_NUM_JS_OUTPUTS,
         libzeth::ZETH_MERKLE_TREE_DEPTH>
         prover;
-    snark::KeypairT keypair = [&keypair_file, &prover]() {
+#ifdef ZKSNARK_GROTH16
+    std::unique_ptr<snark::AffineProvingKeyT> affine_pk;
+#endif
+    snark::KeypairT keypair = [&]() {
         if (!keypair_file.empty()) {
 #ifdef ZKSNARK_GROTH16
             std::cout << "[INFO] Loading keypair: " << keypair_file
                       << std::endl;
-            return load_keypair(keypair_file);
+            return load_keypair(
+                keypair_file, key_checks, affine_proving_key, affine_pk);
 #else
             std::cout << "Keypair loading not supported in this config"
                       << std::endl;
@@ -411,17 +1049,39 @@ int main(int argc, char **argv)
         return keypair;
     }();
 
+#ifdef ZKSNARK_GROTH16
+    if (!mapped_keypair_file.empty()) {
+        if (affine_pk) {
+            std::cerr << " ERROR: cannot write a mapped keypair from a "
+                         "mapped proving key"
+                      << std::endl;
+            return 1;
+        }
+        std::cout << "[INFO] Writing mapped keypair: " << mapped_keypair_file
+                  << std::endl;
+        write_mapped_keypair(keypair, mapped_keypair_file);
+    }
+
+    // The proving key of the keypair is released as it is converted.
+    if (affine_proving_key && !affine_pk) {
+        std::cout << "[INFO] Converting the proving key to affine coordinates"
+                  << std::endl;
+        affine_pk.reset(new snark::AffineProvingKeyT(std::move(keypair.pk)));
+    }
+    server_options.affine_proving_key = affine_pk.get();
+#endif
+
 #ifdef DEBUG
     // Run only if the flag is set
     if (jr1cs_file != "") {
         std::cout << "[DEBUG] Dump R1CS to json file" << std::endl;
         std::ofstream jr1cs_stream(jr1cs_file.c_str());
         libzeth::r1cs_write_json<libzeth::ppT>(
-            prover.get_constraint_system(), jr1cs_stream);
+            prover.get_protoboard(), jr1cs_stream);
     }
 #endif
 
     std::cout << "[INFO] Setup successful, starting the server..." << std::endl;
-    RunServer(prover, keypair);
+    RunServer(prover, keypair, server_options);
     return 0;
 }
@@ -0,0 +1,240 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_PROVER_SERVER_PROVER_SERVER_HPP__
+#define __ZETH_PROVER_SERVER_PROVER_SERVER_HPP__
+
+#include "libzeth/circuits/circuit_types.hpp"
+#include "libzeth/core/extended_proof.hpp"
+#include "libzeth/snarks/default/default_snark.hpp"
+#include "libzeth/zeth_constants.hpp"
+#include "commitment_tree.hpp"
+#include "metrics.hpp"
+#include "proof_cache.hpp"
+#include "proving_job.hpp"
+#include "proving_pool.hpp"
+#include "witness_context_pool.hpp"
+
+#include <api/prover.grpc.pb.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <grpcpp/server_context.h>
+#include <memory>
+#include <string>
+
+using snark = libzeth::default_snark<libzeth::ppT>;
+
+/// Options controlling how requests are scheduled on the proving workers.
+struct prover_server_options {
+    /// Number of proofs which may be generated concurrently.
+    size_t num_workers;
+    /// Maximum number of requests waiting for a worker. Further requests are
+    /// rejected with RESOURCE_EXHAUSTED.
+    size_t max_queued;
+    /// Time after which a Prove request fails with DEADLINE_EXCEEDED (0 means
+    /// no timeout).
+    std::chrono::seconds request_timeout;
+    /// Fraction of requests (in [0, 1]) for which the witness is checked
+    /// against all constraints before generating the proof.
+    double witness_check_rate;
+    /// Write each generated proof to the debug directory (from a background
+    /// thread).
+    bool dump_proofs;
+    /// Generate witnesses on a dedicated thread, overlapping with the proof
+    /// generation of earlier requests on the workers.
+    bool pipeline;
+    /// Maintain a copy of the mixer commitment tree (fed by
+    /// AppendCommitments), used to fill in missing Merkle paths.
+    bool commitment_tree;
+    /// Number of threads (each with its own completion queue) receiving
+    /// Prove and ProveBatch calls and sending their responses.
+    size_t rpc_threads;
+    /// Maximum memory used by the proof cache (0 disables the cache).
+    size_t proof_cache_bytes;
+    /// Time after which a cached proof expires.
+    std::chrono::seconds proof_cache_ttl;
+#ifdef ZKSNARK_GROTH16
+    /// If not null, proofs are generated with this proving key (in affine
+    /// coordinates), and the proving key of the keypair is not used.
+    const snark::AffineProvingKeyT *affine_proving_key;
+#endif
+};
+
+/// Prover service in which the long running Prove and ProveBatch methods are
+/// asynchronous, and the other (fast) methods are synchronous.
+using prover_service_base = zeth_proto::Prover::WithAsyncMethod_Prove<
+    zeth_proto::Prover::WithAsyncMethod_ProveBatch<
+        zeth_proto::Prover::Service>>;
+
+/// The prover_server class inherits from the Prover service
+/// defined in the proto files, and provides an implementation
+/// of the service.
+///
+/// Prove and ProveBatch calls are driven by completion queues (see
+/// `start_async_calls`): the thread receiving a request hands it over to the
+/// proving workers and is then free to handle other calls. The response is
+/// sent by the worker completing the job. The state machines of these calls
+/// are `prove_call` (prove_call.hpp) and `prove_batch_call`
+/// (prove_batch_call.hpp).
+class prover_server final : public prover_service_base
+{
+private:
+    class prove_call;
+    class prove_batch_call;
+
+    using FieldT = libff::Fr<libzeth::ppT>;
+    using prover_circuit = libzeth::circuit_wrapper<
+        libzeth::HashT,
+        libzeth::HashTreeT,
+        libzeth::ppT,
+        snark,
+        libzeth::ZETH_NUM_JS_INPUTS,
+        libzeth::ZETH_NUM_JS_OUTPUTS,
+        libzeth::ZETH_MERKLE_TREE_DEPTH>;
+    using witness_context = prover_circuit::witness_context;
+
+    // The circuit (and its constraint system) is built once at startup and
+    // shared by all requests.
+    const prover_circuit &prover;
+
+    // The keypair is the result of the setup
+    const snark::KeypairT &keypair;
+
+#ifdef ZKSNARK_GROTH16
+    // Proving key in affine coordinates, used instead of keypair.pk if not
+    // null.
+    const snark::AffineProvingKeyT *const affine_proving_key;
+#endif
+
+    const std::chrono::seconds request_timeout;
+    const double witness_check_rate;
+    const bool dump_proofs;
+
+    std::atomic<uint64_t> next_request_id;
+
+    // Size of the proving key in memory, computed once at startup.
+    const size_t proving_key_bytes;
+
+    // Verification key, prepared once for the Verify methods.
+    const snark::PreparedVerificationKeyT prepared_vk;
+
+    prover_metrics metrics;
+
+    // Server copy of the commitment tree (null if not enabled)
+    std::unique_ptr<commitment_tree> commitments;
+
+    // Recently generated proofs (null if not enabled)
+    std::unique_ptr<proof_cache> cache;
+
+    // Witness contexts not currently in use.
+    witness_context_pool<witness_context> witness_contexts;
+
+    // Single background thread writing proof dumps, so that disk I/O is kept
+    // off the proving workers. Dumps are dropped if it falls behind.
+    proving_pool dump_writer;
+
+    // Workers which execute the proof generation, sharing the circuit and
+    // proving key above. Declared after the other members, so that the
+    // workers are joined before those are destroyed.
+    proving_pool pool;
+
+    // When pipelining is enabled, single thread running the witness stage of
+    // each job before handing it over to `pool`. Declared last, since its
+    // tasks submit to `pool`.
+    std::unique_ptr<proving_pool> witness_pool;
+
+public:
+    explicit prover_server(
+        const prover_circuit &prover,
+        const snark::KeypairT &keypair,
+        const prover_server_options &options);
+
+    grpc::Status GetVerificationKey(
+        grpc::ServerContext *,
+        const google::protobuf::Empty *,
+        zeth_proto::VerificationKey *response) override;
+
+    /// Wait for Prove and ProveBatch calls on the given completion queue.
+    /// The queue must be polled by `run_completion_queue`.
+    void start_async_calls(grpc::ServerCompletionQueue *cq);
+
+    grpc::Status GetMetrics(
+        grpc::ServerContext *,
+        const google::protobuf::Empty *,
+        zeth_proto::Metrics *response) override;
+
+    grpc::Status AppendCommitments(
+        grpc::ServerContext *,
+        const zeth_proto::CommitmentBatch *batch,
+        zeth_proto::CommitmentTreeState *response) override;
+
+    grpc::Status GetCommitmentTreeState(
+        grpc::ServerContext *,
+        const google::protobuf::Empty *,
+        zeth_proto::CommitmentTreeState *response) override;
+
+    grpc::Status Verify(
+        grpc::ServerContext *,
+        const zeth_proto::ExtendedProof *proof,
+        zeth_proto::VerificationResult *response) override;
+
+    grpc::Status VerifyBatch(
+        grpc::ServerContext *,
+        const zeth_proto::ExtendedProofs *request,
+        zeth_proto::VerificationResults *response) override;
+
+private:
+    grpc::Status record_request(
+        prover_metrics::rpc_method method, const grpc::Status &status);
+
+    /// Key under which the proof for the given inputs is cached (empty if the
+    /// cache is disabled or the inputs cannot be cached).
+    std::string proof_cache_key(
+        const zeth_proto::ProofInputs &proof_inputs) const;
+
+    /// Look up a previously generated proof. Returns true on a hit.
+    bool lookup_cached_proof(
+        uint64_t request_id,
+        const std::string &cache_key,
+        zeth_proto::ExtendedProof &proof);
+
+    /// Enqueue a proof generation job on the workers. Returns nullptr if the
+    /// queue is full. Otherwise, `on_done` is invoked by the worker once the
+    /// job is complete. If `cache_key` is not empty, the proof is added to
+    /// the cache.
+    std::shared_ptr<proving_job> submit_job(
+        uint64_t request_id,
+        const zeth_proto::ProofInputs &proof_inputs,
+        const std::string &cache_key,
+        const proving_job::completion_handler &on_done);
+
+    /// Executed by the witness thread (in pipelined mode): queue the proof
+    /// stage of a job on the proving workers. If proving is slower than
+    /// witness generation, this blocks until a worker is free, so that the
+    /// witness queue fills up and new requests are rejected at admission,
+    /// rather than failing jobs which have already been admitted.
+    void hand_over_to_proof_stage(const std::shared_ptr<proving_job> &job);
+
+    /// Parse the inputs and generate the witness. Returns false (and
+    /// completes the job) on failure.
+    bool execute_witness_stage(proving_job &job);
+
+    /// Generate the proof from the witness of `job`, with the proving key in
+    /// use.
+    libzeth::extended_proof<libzeth::ppT, snark> generate_proof(
+        const proving_job &job) const;
+
+    /// Generate the proof from the witness computed by
+    /// `execute_witness_stage`, and complete the job.
+    void execute_proof_stage(proving_job &job);
+
+    /// Queue a copy of the proof to be written to the debug directory by the
+    /// background writer.
+    void dump_proof(
+        uint64_t request_id,
+        const libzeth::extended_proof<libzeth::ppT, snark> &ext_proof);
+};
+
+#endif // __ZETH_PROVER_SERVER_PROVER_SERVER_HPP__
@@ -0,0 +1,26 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#include "proving_job.hpp"
+
+proving_job::proving_job(
+    uint64_t request_id,
+    const zeth_proto::ProofInputs &proof_inputs,
+    const std::string &cache_key,
+    const completion_handler &on_done)
+    : request_id(request_id)
+    , proof_inputs(proof_inputs)
+    , cache_key(cache_key)
+    , on_done(on_done)
+    , done(false)
+    , submitted(clock::now())
+{
+}
+
+void complete_job(proving_job &job, std::exception_ptr error)
+{
+    job.error = error;
+    job.done = true;
+    job.on_done(job);
+}
@@ -0,0 +1,61 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_PROVER_SERVER_PROVING_JOB_HPP__
+#define __ZETH_PROVER_SERVER_PROVING_JOB_HPP__
+
+#include "libzeth/circuits/circuit_types.hpp"
+#include "libzeth/core/cancellation.hpp"
+
+#include <api/snark_messages.pb.h>
+#include <api/zeth_messages.pb.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <string>
+
+/// State shared between a call and the worker(s) generating the proof. The
+/// call may cancel the job (on timeout, or if the client goes away), in which
+/// case the workers abandon it at the next phase boundary. Once the job is
+/// complete (successfully or not), the worker invokes `on_done`.
+struct proving_job {
+    using clock = std::chrono::steady_clock;
+    using completion_handler = std::function<void(proving_job &)>;
+
+    const uint64_t request_id;
+    const zeth_proto::ProofInputs proof_inputs;
+    // Key under which the proof is cached (empty if it is not cached).
+    const std::string cache_key;
+    const completion_handler on_done;
+    libzeth::cancellation_token cancellation;
+
+    // Set before `on_done` is invoked. On success, `error` is null and
+    // `result` holds the proof.
+    std::atomic<bool> done;
+    std::exception_ptr error;
+    zeth_proto::ExtendedProof result;
+
+    // Output of the witness stage, consumed by the proof stage.
+    libsnark::r1cs_primary_input<libzeth::FieldT> primary_input;
+    libsnark::r1cs_auxiliary_input<libzeth::FieldT> auxiliary_input;
+
+    // Stage timestamps, for the timing metrics.
+    const clock::time_point submitted;
+    clock::time_point witness_started;
+    clock::time_point witness_done;
+    clock::time_point proof_started;
+
+    proving_job(
+        uint64_t request_id,
+        const zeth_proto::ProofInputs &proof_inputs,
+        const std::string &cache_key,
+        const completion_handler &on_done);
+};
+
+/// Record the outcome of a job and notify its owner.
+void complete_job(proving_job &job, std::exception_ptr error);
+
+#endif // __ZETH_PROVER_SERVER_PROVING_JOB_HPP__
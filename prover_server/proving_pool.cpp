@@ -0,0 +1,113 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#include "proving_pool.hpp"
+
+#ifdef MULTICORE
+#include <omp.h>
+#endif
+
+proving_pool::proving_pool(
+    size_t num_workers, size_t max_queued, size_t threads_per_worker)
+    : max_queued(max_queued)
+    , threads_per_worker(threads_per_worker)
+    , active(0)
+    , stopping(false)
+{
+    workers.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; ++i) {
+        workers.emplace_back([this]() { worker_loop(); });
+    }
+}
+
+proving_pool::~proving_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    tasks_available.notify_all();
+    space_available.notify_all();
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+}
+
+bool proving_pool::try_submit(task t)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping || tasks.size() >= max_queued) {
+            return false;
+        }
+        tasks.push_back(std::move(t));
+    }
+    tasks_available.notify_one();
+    return true;
+}
+
+bool proving_pool::submit(task t)
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        space_available.wait(lock, [this]() {
+            return stopping || tasks.size() < max_queued;
+        });
+        if (stopping) {
+            return false;
+        }
+        tasks.push_back(std::move(t));
+    }
+    tasks_available.notify_one();
+    return true;
+}
+
+size_t proving_pool::num_queued() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return tasks.size();
+}
+
+size_t proving_pool::num_active() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return active;
+}
+
+size_t proving_pool::num_workers() const { return workers.size(); }
+
+void proving_pool::worker_loop()
+{
+#ifdef MULTICORE
+    // The OpenMP thread count is a per-thread setting, and applies to all
+    // parallel regions entered by this worker (FFTs, multi-exponentiations).
+    // Splitting the cores between workers avoids oversubscription when
+    // several proofs are generated concurrently.
+    if (threads_per_worker != 0) {
+        omp_set_num_threads((int)threads_per_worker);
+    }
+#endif
+
+    for (;;) {
+        task t;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            tasks_available.wait(
+                lock, [this]() { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                // Only reachable when stopping, once the queue is drained.
+                return;
+            }
+            t = std::move(tasks.front());
+            tasks.pop_front();
+            ++active;
+        }
+        space_available.notify_one();
+
+        t();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        --active;
+    }
+}
@@ -0,0 +1,71 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_PROVER_SERVER_PROVING_POOL_HPP__
+#define __ZETH_PROVER_SERVER_PROVING_POOL_HPP__
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Fixed-size pool of proving workers, fed by a bounded admission queue.
+/// Tasks are executed in submission order. When the queue is full, new tasks
+/// are either rejected immediately (`try_submit`), so that the server can
+/// report the overload to the client, or wait for space (`submit`), applying
+/// backpressure to the caller.
+class proving_pool
+{
+public:
+    using task = std::function<void()>;
+
+    /// Start `num_workers` threads. At most `max_queued` tasks may be waiting
+    /// (in addition to those being executed). If `threads_per_worker` is
+    /// non-zero, each worker limits the number of OpenMP threads used by its
+    /// own proof generation to this value (only when built with MULTICORE).
+    proving_pool(
+        size_t num_workers, size_t max_queued, size_t threads_per_worker);
+
+    /// Stop accepting tasks, wait for the queued tasks to be executed and
+    /// join all workers.
+    ~proving_pool();
+
+    proving_pool(const proving_pool &) = delete;
+    proving_pool &operator=(const proving_pool &) = delete;
+
+    /// Enqueue a task. Returns false (and does not take the task) if the
+    /// queue is full or the pool is shutting down.
+    bool try_submit(task t);
+
+    /// Enqueue a task, blocking while the queue is full. Returns false (and
+    /// does not take the task) if the pool is shutting down.
+    bool submit(task t);
+
+    /// Number of tasks waiting for a worker.
+    size_t num_queued() const;
+
+    /// Number of workers currently executing a task.
+    size_t num_active() const;
+
+    size_t num_workers() const;
+
+private:
+    void worker_loop();
+
+    const size_t max_queued;
+    const size_t threads_per_worker;
+
+    mutable std::mutex mutex;
+    std::condition_variable tasks_available;
+    std::condition_variable space_available;
+    std::deque<task> tasks;
+    size_t active;
+    bool stopping;
+
+    std::vector<std::thread> workers;
+};
+
+#endif // __ZETH_PROVER_SERVER_PROVING_POOL_HPP__
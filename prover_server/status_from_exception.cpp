@@ -0,0 +1,50 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#include "status_from_exception.hpp"
+
+#include "libzeth/core/cancellation.hpp"
+#include "logging.hpp"
+
+#include <stdexcept>
+
+grpc::Status status_from_exception(
+    uint64_t request_id, std::exception_ptr error)
+{
+    const auto client_error = [request_id](const std::exception &e) {
+        PROVER_LOG(log_level::info, "request_invalid")
+            .field("request", request_id)
+            .field("error", e.what());
+        return grpc::Status(
+            grpc::StatusCode::INVALID_ARGUMENT, grpc::string(e.what()));
+    };
+
+    try {
+        std::rethrow_exception(error);
+    } catch (const libzeth::operation_cancelled &) {
+        PROVER_LOG(log_level::info, "request_cancelled")
+            .field("request", request_id);
+        return grpc::Status(grpc::StatusCode::CANCELLED, "request cancelled");
+    } catch (const std::invalid_argument &e) {
+        return client_error(e);
+    } catch (const std::length_error &e) {
+        // Raised when parsing hexadecimal inputs of the wrong length
+        return client_error(e);
+    } catch (const std::out_of_range &e) {
+        return client_error(e);
+    } catch (const std::overflow_error &e) {
+        // Raised when the note values of the request overflow
+        return client_error(e);
+    } catch (const std::exception &e) {
+        PROVER_LOG(log_level::error, "request_failed")
+            .field("request", request_id)
+            .field("error", e.what());
+        return grpc::Status(grpc::StatusCode::INTERNAL, grpc::string(e.what()));
+    } catch (...) {
+        PROVER_LOG(log_level::error, "request_failed")
+            .field("request", request_id)
+            .field("error", "unknown");
+        return grpc::Status(grpc::StatusCode::UNKNOWN, "");
+    }
+}
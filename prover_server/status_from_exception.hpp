@@ -0,0 +1,21 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_PROVER_SERVER_STATUS_FROM_EXCEPTION_HPP__
+#define __ZETH_PROVER_SERVER_STATUS_FROM_EXCEPTION_HPP__
+
+#include <cstdint>
+#include <exception>
+#include <grpcpp/support/status.h>
+
+/// Map an exception raised while handling a request to a gRPC status (and
+/// log it). Only errors caused by the request contents (invalid values,
+/// malformed or out-of-range encodings, overflowing note values) are reported
+/// as INVALID_ARGUMENT. Cancelled operations are reported as CANCELLED. Other
+/// failures are server-side, and reported as INTERNAL (or UNKNOWN for
+/// exceptions not derived from `std::exception`).
+grpc::Status status_from_exception(
+    uint64_t request_id, std::exception_ptr error);
+
+#endif // __ZETH_PROVER_SERVER_STATUS_FROM_EXCEPTION_HPP__
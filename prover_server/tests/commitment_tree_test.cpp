@@ -0,0 +1,120 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#include "libzeth/core/merkle_tree_field.hpp"
+#include "prover_server/commitment_tree.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace libzeth;
+
+using reference_tree = merkle_tree_field<FieldT, HashTreeT>;
+
+namespace
+{
+
+std::vector<FieldT> random_commitments(size_t num_commitments)
+{
+    std::vector<FieldT> commitments;
+    commitments.reserve(num_commitments);
+    for (size_t i = 0; i < num_commitments; ++i) {
+        commitments.push_back(FieldT::random_element());
+    }
+    return commitments;
+}
+
+void assert_path_matches(
+    const reference_tree &expected, const commitment_tree &tree, size_t address)
+{
+    std::vector<FieldT> path;
+    FieldT root;
+    tree.get_path(address, path, root);
+    ASSERT_EQ(expected.get_path(address), path);
+    ASSERT_EQ(expected.get_root(), root);
+}
+
+TEST(CommitmentTreeTest, RejectWrongFirstAddress)
+{
+    commitment_tree tree;
+    size_t num_commitments;
+    FieldT root;
+
+    ASSERT_THROW(
+        tree.append(1, random_commitments(2), num_commitments, root),
+        std::invalid_argument);
+
+    tree.append(0, random_commitments(2), num_commitments, root);
+    ASSERT_EQ(2U, num_commitments);
+
+    // Repeated and skipped batches are rejected, leaving the tree unchanged.
+    ASSERT_THROW(
+        tree.append(0, random_commitments(2), num_commitments, root),
+        std::invalid_argument);
+    ASSERT_THROW(
+        tree.append(3, random_commitments(2), num_commitments, root),
+        std::invalid_argument);
+    size_t state_num_commitments;
+    FieldT state_root;
+    tree.get_state(state_num_commitments, state_root);
+    ASSERT_EQ(2U, state_num_commitments);
+    ASSERT_EQ(root, state_root);
+
+    tree.append(2, random_commitments(1), num_commitments, root);
+    ASSERT_EQ(3U, num_commitments);
+}
+
+TEST(CommitmentTreeTest, PathsMatchMerkleTreeField)
+{
+    commitment_tree tree;
+    reference_tree expected(ZETH_MERKLE_TREE_DEPTH);
+    size_t num_commitments = 0;
+    FieldT root;
+
+    const size_t batch_sizes[] = {1, 4, 3};
+    for (const size_t batch_size : batch_sizes) {
+        const std::vector<FieldT> commitments = random_commitments(batch_size);
+        const size_t first_address = num_commitments;
+        tree.append(first_address, commitments, num_commitments, root);
+        for (size_t i = 0; i < batch_size; ++i) {
+            expected.set_value(first_address + i, commitments[i]);
+        }
+        ASSERT_EQ(expected.get_root(), root);
+
+        for (size_t address = 0; address < num_commitments; ++address) {
+            assert_path_matches(expected, tree, address);
+        }
+    }
+
+    // Addresses which have not been appended yet have default paths.
+    assert_path_matches(expected, tree, num_commitments);
+    assert_path_matches(expected, tree, num_commitments + 5);
+}
+
+TEST(CommitmentTreeTest, DummyInputOnEmptyTree)
+{
+    // Zero-valued inputs use address 0, even before the first commitment is
+    // appended.
+    const commitment_tree tree;
+    const reference_tree expected(ZETH_MERKLE_TREE_DEPTH);
+    assert_path_matches(expected, tree, 0);
+}
+
+TEST(CommitmentTreeTest, RejectAddressOutOfRange)
+{
+    const commitment_tree tree;
+    std::vector<FieldT> path;
+    FieldT root;
+    ASSERT_THROW(
+        tree.get_path((size_t)1 << ZETH_MERKLE_TREE_DEPTH, path, root),
+        std::invalid_argument);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    ppT::init_public_params();
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,161 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#include "prover_server/metrics.hpp"
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+std::vector<std::string> lines_of(const std::string &text)
+{
+    std::vector<std::string> lines;
+    std::istringstream ss(text);
+    std::string line;
+    while (std::getline(ss, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+bool has_line(const std::string &text, const std::string &line)
+{
+    for (const std::string &l : lines_of(text)) {
+        if (l == line) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool has_line_starting_with(const std::string &text, const std::string &prefix)
+{
+    for (const std::string &l : lines_of(text)) {
+        if (l.compare(0, prefix.size(), prefix) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Every line is either a HELP or TYPE comment, or a sample of the form
+// `name{labels} value`.
+void check_prometheus_text_format(const std::string &text)
+{
+    const std::regex comment("# (HELP|TYPE) [a-z_]+ .+");
+    const std::regex sample("[a-z_]+(\\{[^}]*\\})? [0-9.e+-]+");
+    for (const std::string &line : lines_of(text)) {
+        ASSERT_TRUE(
+            std::regex_match(line, comment) || std::regex_match(line, sample))
+            << "invalid line: " << line;
+    }
+}
+
+TEST(MetricsTest, HistogramBucketsAreCumulative)
+{
+    duration_histogram histogram;
+    histogram.observe(std::chrono::microseconds(500));
+    histogram.observe(std::chrono::microseconds(1500));
+    histogram.observe(std::chrono::seconds(400));
+
+    std::ostringstream ss;
+    histogram.write_prometheus(ss, "duration", "");
+    const std::string text = ss.str();
+    check_prometheus_text_format(text);
+
+    // 16 buckets, plus +Inf, _sum and _count.
+    ASSERT_EQ(19U, lines_of(text).size());
+    ASSERT_TRUE(has_line(text, "duration_bucket{le=\"0.001\"} 1"));
+    ASSERT_TRUE(has_line(text, "duration_bucket{le=\"0.005\"} 2"));
+    ASSERT_TRUE(has_line(text, "duration_bucket{le=\"300\"} 2"));
+    ASSERT_TRUE(has_line(text, "duration_bucket{le=\"+Inf\"} 3"));
+    ASSERT_TRUE(has_line(text, "duration_sum{} 400.002"));
+    ASSERT_TRUE(has_line(text, "duration_count{} 3"));
+}
+
+TEST(MetricsTest, HistogramLabels)
+{
+    duration_histogram histogram;
+    histogram.observe(std::chrono::milliseconds(20));
+
+    std::ostringstream ss;
+    histogram.write_prometheus(ss, "duration", "phase=\"proof\"");
+    const std::string text = ss.str();
+    check_prometheus_text_format(text);
+
+    ASSERT_TRUE(
+        has_line(text, "duration_bucket{phase=\"proof\",le=\"0.01\"} 0"));
+    ASSERT_TRUE(
+        has_line(text, "duration_bucket{phase=\"proof\",le=\"0.025\"} 1"));
+    ASSERT_TRUE(has_line(text, "duration_count{phase=\"proof\"} 1"));
+}
+
+TEST(MetricsTest, RequestCountsAndPhases)
+{
+    prover_metrics metrics;
+    metrics.record_request(prover_metrics::rpc_method::prove, 0);
+    metrics.record_request(prover_metrics::rpc_method::prove, 0);
+    metrics.record_request(prover_metrics::rpc_method::prove, 8);
+    // Out of range status codes are counted as UNKNOWN.
+    metrics.record_request(prover_metrics::rpc_method::prove, 42);
+    metrics.record_phase(prover_metrics::phase::proof, std::chrono::seconds(2));
+
+    std::ostringstream ss;
+    metrics.write_prometheus(ss);
+    const std::string text = ss.str();
+    check_prometheus_text_format(text);
+
+    ASSERT_TRUE(has_line(text, "# TYPE zeth_prover_requests_total counter"));
+    ASSERT_TRUE(has_line(
+        text, "zeth_prover_requests_total{method=\"Prove\",code=\"OK\"} 2"));
+    ASSERT_TRUE(has_line(
+        text,
+        "zeth_prover_requests_total{method=\"Prove\","
+        "code=\"RESOURCE_EXHAUSTED\"} 1"));
+    ASSERT_TRUE(has_line(
+        text,
+        "zeth_prover_requests_total{method=\"Prove\",code=\"UNKNOWN\"} 1"));
+
+    // OK is always reported, other codes only once they occur.
+    ASSERT_TRUE(has_line(
+        text,
+        "zeth_prover_requests_total{method=\"GetMetrics\",code=\"OK\"} 0"));
+    ASSERT_FALSE(has_line_starting_with(
+        text,
+        "zeth_prover_requests_total{method=\"Prove\",code=\"INTERNAL\"}"));
+
+    ASSERT_TRUE(has_line(
+        text, "# TYPE zeth_prover_phase_duration_seconds histogram"));
+    ASSERT_TRUE(has_line(
+        text,
+        "zeth_prover_phase_duration_seconds_bucket{phase=\"proof\",le=\"1\"} "
+        "0"));
+    ASSERT_TRUE(has_line(
+        text,
+        "zeth_prover_phase_duration_seconds_bucket{phase=\"proof\",le=\"2.5\"}"
+        " 1"));
+    ASSERT_TRUE(has_line(
+        text, "zeth_prover_phase_duration_seconds_count{phase=\"proof\"} 1"));
+    ASSERT_TRUE(has_line(
+        text, "zeth_prover_phase_duration_seconds_count{phase=\"witness\"} 0"));
+}
+
+TEST(MetricsTest, Gauge)
+{
+    std::ostringstream ss;
+    write_prometheus_gauge(ss, "zeth_prover_queue_depth", "Queued jobs.", 3);
+    ASSERT_EQ(
+        "# HELP zeth_prover_queue_depth Queued jobs.\n"
+        "# TYPE zeth_prover_queue_depth gauge\n"
+        "zeth_prover_queue_depth 3\n",
+        ss.str());
+}
+
+} // namespace
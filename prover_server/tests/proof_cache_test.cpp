@@ -0,0 +1,140 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#include "prover_server/proof_cache.hpp"
+
+#include "libzeth/mpc/groth16/mpc_hash.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+
+namespace
+{
+
+zeth_proto::ExtendedProof dummy_proof(const std::string &inputs)
+{
+    zeth_proto::ExtendedProof proof;
+    proof.mutable_groth16_extended_proof()->set_inputs(inputs);
+    return proof;
+}
+
+zeth_proto::ProofInputs dummy_inputs(const std::string &root)
+{
+    zeth_proto::ProofInputs inputs;
+    inputs.add_mk_roots(root);
+    inputs.add_mk_roots(root);
+    inputs.set_pub_in_value("0000000000000001");
+    inputs.set_pub_out_value("0000000000000000");
+    return inputs;
+}
+
+// Memory accounted for a single entry
+size_t entry_size(const std::string &key, const zeth_proto::ExtendedProof &p)
+{
+    proof_cache cache(1 << 20, std::chrono::seconds(600));
+    cache.insert(key, p);
+    return cache.num_bytes();
+}
+
+TEST(ProofCacheTest, Key)
+{
+    const std::string key_1 = proof_cache::key(dummy_inputs("0x01"));
+    ASSERT_EQ(key_1, proof_cache::key(dummy_inputs("0x01")));
+    ASSERT_NE(key_1, proof_cache::key(dummy_inputs("0x02")));
+    ASSERT_EQ(libzeth::MPC_HASH_SIZE_BYTES, key_1.size());
+}
+
+TEST(ProofCacheTest, IsCacheable)
+{
+    ASSERT_TRUE(proof_cache::is_cacheable(dummy_inputs("0x01")));
+    ASSERT_TRUE(proof_cache::is_cacheable(zeth_proto::ProofInputs()));
+    ASSERT_FALSE(proof_cache::is_cacheable(dummy_inputs("")));
+
+    // A single empty root is enough for the proof to depend on the server.
+    zeth_proto::ProofInputs inputs = dummy_inputs("0x01");
+    inputs.set_mk_roots(1, "");
+    ASSERT_FALSE(proof_cache::is_cacheable(inputs));
+}
+
+TEST(ProofCacheTest, LookupAndReplace)
+{
+    proof_cache cache(1 << 20, std::chrono::seconds(600));
+    zeth_proto::ExtendedProof proof;
+    ASSERT_FALSE(cache.lookup("a", proof));
+
+    cache.insert("a", dummy_proof("proof_a"));
+    ASSERT_TRUE(cache.lookup("a", proof));
+    ASSERT_EQ("proof_a", proof.groth16_extended_proof().inputs());
+
+    // Inserting under an existing key replaces the entry.
+    cache.insert("a", dummy_proof("proof_a_2"));
+    ASSERT_EQ(1U, cache.num_entries());
+    ASSERT_EQ(entry_size("a", dummy_proof("proof_a_2")), cache.num_bytes());
+    ASSERT_TRUE(cache.lookup("a", proof));
+    ASSERT_EQ("proof_a_2", proof.groth16_extended_proof().inputs());
+}
+
+TEST(ProofCacheTest, EvictLeastRecentlyUsed)
+{
+    const size_t size = entry_size("a", dummy_proof("proof_a"));
+
+    // Room for two entries, but not three.
+    proof_cache cache(2 * size + size / 2, std::chrono::seconds(600));
+    cache.insert("a", dummy_proof("proof_a"));
+    cache.insert("b", dummy_proof("proof_b"));
+    ASSERT_EQ(2U, cache.num_entries());
+    ASSERT_EQ(2 * size, cache.num_bytes());
+
+    // Using "a" makes "b" the least recently used entry.
+    zeth_proto::ExtendedProof proof;
+    ASSERT_TRUE(cache.lookup("a", proof));
+
+    cache.insert("c", dummy_proof("proof_c"));
+    ASSERT_EQ(2U, cache.num_entries());
+    ASSERT_EQ(2 * size, cache.num_bytes());
+    ASSERT_FALSE(cache.lookup("b", proof));
+    ASSERT_TRUE(cache.lookup("a", proof));
+    ASSERT_EQ("proof_a", proof.groth16_extended_proof().inputs());
+    ASSERT_TRUE(cache.lookup("c", proof));
+    ASSERT_EQ("proof_c", proof.groth16_extended_proof().inputs());
+
+    // A larger entry evicts as many entries as necessary.
+    cache.insert("d", dummy_proof("proof_d" + std::string(size, '0')));
+    ASSERT_EQ(1U, cache.num_entries());
+    ASSERT_FALSE(cache.lookup("a", proof));
+    ASSERT_FALSE(cache.lookup("c", proof));
+    ASSERT_TRUE(cache.lookup("d", proof));
+}
+
+TEST(ProofCacheTest, Expiry)
+{
+    // With a TTL of 0, entries have expired as soon as they are inserted.
+    proof_cache cache(1 << 20, std::chrono::seconds(0));
+    cache.insert("a", dummy_proof("proof_a"));
+    ASSERT_EQ(1U, cache.num_entries());
+
+    // Expired entries are removed when looked up.
+    zeth_proto::ExtendedProof proof;
+    ASSERT_FALSE(cache.lookup("a", proof));
+    ASSERT_EQ(0U, cache.num_entries());
+    ASSERT_EQ(0U, cache.num_bytes());
+}
+
+TEST(ProofCacheTest, IgnoreOversizedProofs)
+{
+    const size_t size = entry_size("a", dummy_proof("proof_a"));
+    proof_cache cache(2 * size, std::chrono::seconds(600));
+    cache.insert("a", dummy_proof("proof_a"));
+
+    // A proof larger than the whole cache is not inserted, and does not
+    // evict anything.
+    cache.insert("b", dummy_proof(std::string(2 * size, '0')));
+    zeth_proto::ExtendedProof proof;
+    ASSERT_FALSE(cache.lookup("b", proof));
+    ASSERT_EQ(1U, cache.num_entries());
+    ASSERT_EQ(size, cache.num_bytes());
+    ASSERT_TRUE(cache.lookup("a", proof));
+}
+
+} // namespace
@@ -0,0 +1,82 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#include "prover_server/proving_pool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+
+namespace
+{
+
+TEST(ProvingPoolTest, TrySubmitRejectsWhenQueueIsFull)
+{
+    std::atomic<bool> release(false);
+    std::atomic<size_t> executed(0);
+    {
+        proving_pool pool(1, 1, 0);
+        const proving_pool::task blocking_task = [&]() {
+            while (!release) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            ++executed;
+        };
+
+        ASSERT_TRUE(pool.try_submit(blocking_task));
+        // Wait for the worker to pick up the first task, so that the second
+        // one occupies the (single) queue slot.
+        while (pool.num_active() == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ASSERT_TRUE(pool.try_submit(blocking_task));
+        ASSERT_FALSE(pool.try_submit(blocking_task));
+
+        release = true;
+    }
+    ASSERT_EQ(2U, executed);
+}
+
+// Two-stage pipeline as used by the prover server: a single "witness" thread
+// hands each job over to the "proving" workers. Proving is slower than
+// witness generation, so the hand-over must wait (rather than fail) and every
+// admitted job must complete.
+TEST(ProvingPoolTest, HandOverWaitsWhenProvingIsSlower)
+{
+    const size_t num_jobs = 16;
+    std::atomic<size_t> proved(0);
+    std::atomic<size_t> hand_over_failures(0);
+    size_t admitted = 0;
+    {
+        // Declared in this order so that the witness stage is destroyed (and
+        // drained) first, as in the server.
+        proving_pool pool(2, 1, 0);
+        std::unique_ptr<proving_pool> witness_pool(
+            new proving_pool(1, num_jobs, 1));
+
+        for (size_t i = 0; i < num_jobs; ++i) {
+            const bool ok = witness_pool->try_submit([&]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                const bool handed_over = pool.submit([&]() {
+                    std::this_thread::sleep_for(
+                        std::chrono::milliseconds(10));
+                    ++proved;
+                });
+                if (!handed_over) {
+                    ++hand_over_failures;
+                }
+            });
+            admitted += ok ? 1 : 0;
+        }
+        ASSERT_EQ(num_jobs, admitted);
+        witness_pool.reset();
+    }
+
+    ASSERT_EQ(0U, hand_over_failures);
+    ASSERT_EQ(num_jobs, proved);
+}
+
+} // namespace
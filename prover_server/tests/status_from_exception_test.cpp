@@ -0,0 +1,79 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#include "libzeth/core/cancellation.hpp"
+#include "prover_server/logging.hpp"
+#include "prover_server/status_from_exception.hpp"
+
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+
+template<typename ExceptionT>
+grpc::Status status_from(const ExceptionT &exception)
+{
+    return status_from_exception(0, std::make_exception_ptr(exception));
+}
+
+TEST(StatusFromExceptionTest, ClientErrors)
+{
+    const grpc::Status invalid_argument =
+        status_from(std::invalid_argument("invalid_argument"));
+    ASSERT_EQ(grpc::StatusCode::INVALID_ARGUMENT, invalid_argument.error_code());
+    ASSERT_EQ("invalid_argument", invalid_argument.error_message());
+
+    const grpc::Status length_error =
+        status_from(std::length_error("length_error"));
+    ASSERT_EQ(grpc::StatusCode::INVALID_ARGUMENT, length_error.error_code());
+    ASSERT_EQ("length_error", length_error.error_message());
+
+    const grpc::Status out_of_range =
+        status_from(std::out_of_range("out_of_range"));
+    ASSERT_EQ(grpc::StatusCode::INVALID_ARGUMENT, out_of_range.error_code());
+    ASSERT_EQ("out_of_range", out_of_range.error_message());
+
+    const grpc::Status overflow_error =
+        status_from(std::overflow_error("overflow_error"));
+    ASSERT_EQ(grpc::StatusCode::INVALID_ARGUMENT, overflow_error.error_code());
+    ASSERT_EQ("overflow_error", overflow_error.error_message());
+}
+
+TEST(StatusFromExceptionTest, Cancelled)
+{
+    const grpc::Status status = status_from(libzeth::operation_cancelled());
+    ASSERT_EQ(grpc::StatusCode::CANCELLED, status.error_code());
+}
+
+TEST(StatusFromExceptionTest, ServerErrors)
+{
+    // Errors not caused by the request contents, including other logic and
+    // runtime errors, are internal.
+    const grpc::Status runtime_error =
+        status_from(std::runtime_error("runtime_error"));
+    ASSERT_EQ(grpc::StatusCode::INTERNAL, runtime_error.error_code());
+    ASSERT_EQ("runtime_error", runtime_error.error_message());
+
+    const grpc::Status logic_error = status_from(std::logic_error("logic"));
+    ASSERT_EQ(grpc::StatusCode::INTERNAL, logic_error.error_code());
+
+    const grpc::Status bad_alloc = status_from(std::bad_alloc());
+    ASSERT_EQ(grpc::StatusCode::INTERNAL, bad_alloc.error_code());
+
+    // Exceptions not derived from std::exception
+    const grpc::Status unknown = status_from(42);
+    ASSERT_EQ(grpc::StatusCode::UNKNOWN, unknown.error_code());
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    // Only errors are logged.
+    set_log_level(log_level::error);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,73 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#include "prover_server/witness_context_pool.hpp"
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+struct dummy_context {
+    static std::atomic<size_t> num_created;
+    dummy_context() { ++num_created; }
+};
+
+std::atomic<size_t> dummy_context::num_created(0);
+
+TEST(WitnessContextPoolTest, ReuseReleasedContexts)
+{
+    dummy_context::num_created = 0;
+    witness_context_pool<dummy_context> pool;
+    ASSERT_EQ(0U, pool.num_free());
+
+    // Contexts are created while none is free.
+    std::unique_ptr<dummy_context> a = pool.acquire();
+    std::unique_ptr<dummy_context> b = pool.acquire();
+    ASSERT_EQ(2U, dummy_context::num_created);
+    ASSERT_NE(a.get(), b.get());
+
+    const dummy_context *a_ptr = a.get();
+    pool.release(std::move(a));
+    ASSERT_EQ(1U, pool.num_free());
+
+    // Released contexts are reused.
+    std::unique_ptr<dummy_context> c = pool.acquire();
+    ASSERT_EQ(a_ptr, c.get());
+    ASSERT_EQ(2U, dummy_context::num_created);
+    ASSERT_EQ(0U, pool.num_free());
+
+    pool.release(std::move(b));
+    pool.release(std::move(c));
+    ASSERT_EQ(2U, pool.num_free());
+}
+
+TEST(WitnessContextPoolTest, AtMostOneContextPerThread)
+{
+    const size_t num_threads = 4;
+    const size_t num_iterations = 1000;
+    dummy_context::num_created = 0;
+    witness_context_pool<dummy_context> pool;
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&pool]() {
+            for (size_t j = 0; j < num_iterations; ++j) {
+                pool.release(pool.acquire());
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_LE(dummy_context::num_created, num_threads);
+    ASSERT_EQ(dummy_context::num_created, pool.num_free());
+}
+
+} // namespace
@@ -0,0 +1,42 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_PROVER_SERVER_WITNESS_CONTEXT_POOL_HPP__
+#define __ZETH_PROVER_SERVER_WITNESS_CONTEXT_POOL_HPP__
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/// Witness contexts not currently in use. A thread running a witness stage
+/// takes one (creating it if none is free) and returns it afterwards, so
+/// there are at most as many contexts as threads running witness stages.
+/// `ContextT` must be default constructible.
+template<typename ContextT> class witness_context_pool
+{
+public:
+    witness_context_pool() = default;
+
+    witness_context_pool(const witness_context_pool &) = delete;
+    witness_context_pool &operator=(const witness_context_pool &) = delete;
+
+    /// Take a free context, or create one if none is free.
+    std::unique_ptr<ContextT> acquire();
+
+    /// Return a context obtained from `acquire`, for use by later witness
+    /// stages.
+    void release(std::unique_ptr<ContextT> context);
+
+    /// Number of contexts waiting to be reused.
+    size_t num_free() const;
+
+private:
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<ContextT>> free_contexts;
+};
+
+#include "witness_context_pool.tcc"
+
+#endif // __ZETH_PROVER_SERVER_WITNESS_CONTEXT_POOL_HPP__
@@ -0,0 +1,38 @@
+// Copyright (c) 2015-2020 Clearmatics Technologies Ltd
+//
+// SPDX-License-Identifier: LGPL-3.0+
+
+#ifndef __ZETH_PROVER_SERVER_WITNESS_CONTEXT_POOL_TCC__
+#define __ZETH_PROVER_SERVER_WITNESS_CONTEXT_POOL_TCC__
+
+#include "witness_context_pool.hpp"
+
+template<typename ContextT>
+std::unique_ptr<ContextT> witness_context_pool<ContextT>::acquire()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!free_contexts.empty()) {
+            std::unique_ptr<ContextT> context = std::move(free_contexts.back());
+            free_contexts.pop_back();
+            return context;
+        }
+    }
+    return std::unique_ptr<ContextT>(new ContextT());
+}
+
+template<typename ContextT>
+void witness_context_pool<ContextT>::release(std::unique_ptr<ContextT> context)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    free_contexts.push_back(std::move(context));
+}
+
+template<typename ContextT>
+size_t witness_context_pool<ContextT>::num_free() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return free_contexts.size();
+}
+
+#endif // __ZETH_PROVER_SERVER_WITNESS_CONTEXT_POOL_TCC__